@@ -376,8 +376,18 @@ int AddNewEdge( BNS_VERTEX *p1, BNS_VERTEX *p2, BN_STRUCT *pBNS, int nEdgeCap, i
 int bAddStCapToAVertex( BN_STRUCT *pBNS, Vertex v1, Vertex v2, VertexFlow *nOldCapVertSingleBond, int *nDots, int bAdjacentDonors );
 
 static void remove_alt_bond_marks( inp_ATOM *at, int num_atoms );
+static int bIsBnsNormalizationTrivial( inp_ATOM *at, int num_atoms );
 int bIsBnsEndpoint( BN_STRUCT *pBNS, int v );
 
+/* v. 1.07+: per-thread pool of balanced network arrays */
+static BNS_POOL *GetBnsPool( CANON_GLOBALS *pCG );
+static void *BnsPoolReserve( BNS_POOL *pPool, void *p, int *pnLen, int nLen, size_t nSize );
+static BN_DATA *BnsPoolTakeData( BNS_POOL *pPool, int max_num_vertices, int max_len_Pu_Pv );
+
+/* v. 1.07+: neighbors of s the balanced network search may use */
+static void FillRescapVert( BN_STRUCT *pBNS, BN_DATA *pBD, const Vertex *BaseVert, int nNumBaseVert, BNS_FLOW_CHANGES *fcd );
+static void AddRescapVert( BN_STRUCT *pBNS, BN_DATA *pBD, Vertex v );
+
 /* Protons removal, charge neutralization */
 /* int is_acidic_CO(inp_ATOM* atom, int at_no); */ /* djb-rwth: function definition not found*/
 int mark_at_type( inp_ATOM *atom, int num_atoms, int nAtTypeTotals[] );
@@ -431,6 +441,17 @@ int bHasChargedNeighbor( inp_ATOM *at, int iat );
 #define SwitchEdge_Vert2(u) Get2ndEdgeVertex( pBNS, SwitchEdge[u] )
 #define SwitchEdge_IEdge(u) SwitchEdge[u][1]
 /*****************************************************************************/
+/**** v. 1.07+: what GetVertexNeighbor() and rescap() return, without  *****/
+/**** the calls, for the edge pEdge from the x or y vertex u to another *****/
+/**** atom vertex and for the edge pStEdge between s or t and an atom   *****/
+#define BNS_ATOM_NEIGHBOR(u, pEdge)          ((((u) - 2) ^ (2 * (pEdge)->neighbor12 + 1)) + 2)
+#define BNS_ATOM_RESCAP(u, pEdge)            (((u) & 1) ? ((pEdge)->flow & EDGE_FLOW_MASK) : \
+                                              (int) (pEdge)->cap - ((pEdge)->flow & EDGE_FLOW_MASK))
+#define BNS_ST_RESCAP(pStEdge, bBackward)    ((bBackward) ? ((pStEdge)->flow & EDGE_FLOW_ST_MASK) : \
+                                              (int) (pStEdge)->cap - ((pStEdge)->flow & EDGE_FLOW_ST_MASK))
+/**** v. 1.07+: the st-edge may be used by the search from s              *****/
+#define BNS_ST_HAS_RESCAP(pStEdge)           (((pStEdge)->cap & EDGE_FLOW_ST_MASK) && BNS_ST_RESCAP(pStEdge, 0) > 0)
+/*****************************************************************************/
 
 
 
@@ -683,12 +704,86 @@ exit_function:
 }
 
 
+/****************************************************************************
+ v. 1.07+: fill pBD->RescapVert[] with ascending numbers of the vertices
+ whose st-edges have residual capacity, that is, of the only neighbors
+ of s the balanced network search can use.
+ If BaseVert is NULL all vertices are checked; otherwise only BaseVert[]
+ and the vertices whose st-edges have been changed by
+ bSetFlowToCheckOneBond() as recorded in fcd[].
+****************************************************************************/
+static void FillRescapVert( BN_STRUCT *pBNS,
+                            BN_DATA *pBD,
+                            const Vertex *BaseVert,
+                            int nNumBaseVert,
+                            BNS_FLOW_CHANGES *fcd )
+{
+    int i;
+
+    pBD->nNumRescapVert = 0;
+    if (!BaseVert)
+    {
+        for (i = 0; i < pBNS->num_vertices; i++)
+        {
+            if (BNS_ST_HAS_RESCAP( &pBNS->vert[i].st_edge ))
+            {
+                pBD->RescapVert[pBD->nNumRescapVert++] = i;
+            }
+        }
+        return;
+    }
+    for (i = 0; i < nNumBaseVert; i++)
+    {
+        AddRescapVert( pBNS, pBD, BaseVert[i] );
+    }
+    for (i = 0; fcd && NO_VERTEX != fcd[i].iedge; i++)
+    {
+        AddRescapVert( pBNS, pBD, fcd[i].v1 );
+        AddRescapVert( pBNS, pBD, fcd[i].v2 );
+    }
+}
+
+
+/****************************************************************************
+ v. 1.07+: insert vertex v into pBD->RescapVert[] if its st-edge has
+ residual capacity and it is not there yet
+****************************************************************************/
+static void AddRescapVert( BN_STRUCT *pBNS, BN_DATA *pBD, Vertex v )
+{
+    int i;
+
+    if (pBD->nNumRescapVert < 0 || v < 0 || v >= pBNS->num_vertices ||
+         !BNS_ST_HAS_RESCAP( &pBNS->vert[v].st_edge ))
+    {
+        return;
+    }
+    for (i = pBD->nNumRescapVert; 0 < i && v <= pBD->RescapVert[i - 1]; i--)
+    {
+        if (v == pBD->RescapVert[i - 1])
+        {
+            return;
+        }
+    }
+    memmove( pBD->RescapVert + i + 1, pBD->RescapVert + i, ( (long long) pBD->nNumRescapVert - i ) * sizeof( pBD->RescapVert[0] ) );
+    pBD->RescapVert[i] = v;
+    pBD->nNumRescapVert++;
+}
+
+
 /****************************************************************************
 Run BalancedNetworkSearch( ... ) until no aug pass is found
 ****************************************************************************/
 int RunBalancedNetworkSearch( BN_STRUCT *pBNS, BN_DATA *pBD, int bChangeFlow )
 {
     int pass, delta = 0, nSumDelta;
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+    /* unless the caller has listed the neighbors of s, find them once for all passes */
+    int bOwnRescapVert = ( pBD->nNumRescapVert < 0 );
+    if (bOwnRescapVert)
+    {
+        FillRescapVert( pBNS, pBD, NULL, 0, NULL );
+    }
+#endif
 
     nSumDelta = 0;
     for (pass = 0; pass < pBNS->max_altp; pass++)
@@ -701,12 +796,23 @@ int RunBalancedNetworkSearch( BN_STRUCT *pBNS, BN_DATA *pBD, int bChangeFlow )
         {
             pBNS->num_altp++;
             nSumDelta += abs( delta );
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+            /* the augmenting path has changed st-edges of its two ends only */
+            AddRescapVert( pBNS, pBD, ALTP_START_ATOM( pBNS->alt_path ) );
+            AddRescapVert( pBNS, pBD, ALTP_END_ATOM( pBNS->alt_path ) );
+#endif
         }
         else
         {
             break;
         }
     }
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+    if (bOwnRescapVert)
+    {
+        pBD->nNumRescapVert = -1;
+    }
+#endif
 
     if (IS_BNS_ERROR( delta ))
     {
@@ -1833,12 +1939,25 @@ int BnsTestAndMarkAltBonds( BN_STRUCT *pBNS,
     int ret, iat, ineigh, neigh;
     int nMinFlow, nMaxFlow, nTestFlow, nCurFlow;
     int iedge, bError, nDots, nChanges, bTestForNonStereoBond; /* djb-rwth: removing redundant variables */
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+    int     nNumBaseVert; /* v. 1.07+: number of vertices with residual st-capacity before the tests */
+#endif
 
     /* Normalize bonds and find tautomeric groups */
     bError = 0;
     nChanges = 0;
     bTestForNonStereoBond = pBNS->tot_st_cap > pBNS->tot_st_flow;
 
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+    /* Each test restores the flows it changes, and only the st-edges of the */
+    /* vertices recorded in fcd[] may get residual capacity; the search from */
+    /* s needs to look only at them and at pBD->BaseVert[]                   */
+    FillRescapVert( pBNS, pBD, NULL, 0, NULL );
+    nNumBaseVert = pBD->nNumRescapVert;
+    pBD->nNumRescapVert = -1;
+    memcpy( pBD->BaseVert, pBD->RescapVert, nNumBaseVert * sizeof( pBD->BaseVert[0] ) );
+#endif
+
     for (iat = 0; iat < num_atoms && !bError; iat++)
     {
         for (ineigh = 0; ineigh < at[iat].valence && !bError; ineigh++)
@@ -1901,7 +2020,13 @@ int BnsTestAndMarkAltBonds( BN_STRUCT *pBNS,
                 {
                     if (nDots > 0)
                     {
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+                        FillRescapVert( pBNS, pBD, pBD->BaseVert, nNumBaseVert, fcd );
+#endif
                         ret = RunBalancedNetworkSearch( pBNS, pBD, bChangeFlow );
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+                        pBD->nNumRescapVert = -1;
+#endif
                         if (IS_BNS_ERROR( ret ))
                         {
                             bError = ret;
@@ -1998,6 +2123,68 @@ static void remove_alt_bond_marks( inp_ATOM *at, int num_atoms )
 }
 
 
+/****************************************************************************
+ v. 1.07+: returns 1 if the balanced network search in
+ mark_alt_bonds_and_taut_groups() cannot change the component, that is,
+ all atoms are neutral non-radical C or H, all bonds are single, double
+ or triple, and no atom has more than one multiple bond nor is connected
+ by a single bond to another atom that has one.
+
+ Then all st-edges are saturated, so no augmenting path starts at s;
+ an alternating path that would shift a bond order needs, at each of its
+ inner atoms, a multiple bond followed by another bond of the same atom
+ to an atom with a multiple bond, that is, a conjugated pair; and
+ without heteroatoms and charges there are no tautomeric endpoints,
+ salt or charge group candidates.
+****************************************************************************/
+static int bIsBnsNormalizationTrivial( inp_ATOM *at, int num_atoms )
+{
+    int i, j, bond_type, nBondOrderSum, nNumMultBonds;
+
+    for (i = 0; i < num_atoms; i++)
+    {
+        if (( at[i].el_number != EL_NUMBER_C && at[i].el_number != EL_NUMBER_H ) ||
+             at[i].charge || at[i].radical)
+        {
+            return 0;
+        }
+        nBondOrderSum = nNumMultBonds = 0;
+        for (j = 0; j < at[i].valence; j++)
+        {
+            bond_type = at[i].bond_type[j] & BOND_TYPE_MASK;
+            if (bond_type != BOND_SINGLE && bond_type != BOND_DOUBLE && bond_type != BOND_TRIPLE)
+            {
+                return 0;
+            }
+            nBondOrderSum += bond_type;
+            nNumMultBonds += ( bond_type != BOND_SINGLE );
+        }
+        if (nNumMultBonds > 1 || nBondOrderSum != at[i].chem_bonds_valence)
+        {
+            return 0;
+        }
+    }
+    /* here chem_bonds_valence > valence means the atom has a multiple bond */
+    for (i = 0; i < num_atoms; i++)
+    {
+        if (at[i].chem_bonds_valence == at[i].valence)
+        {
+            continue;
+        }
+        for (j = 0; j < at[i].valence; j++)
+        {
+            if (( at[i].bond_type[j] & BOND_TYPE_MASK ) == BOND_SINGLE &&
+                 at[at[i].neighbor[j]].chem_bonds_valence > at[at[i].neighbor[j]].valence)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+
 /****************************************************************************/
 int SetForbiddenEdges( BN_STRUCT *pBNS,
                        inp_ATOM *at,
@@ -5293,6 +5480,40 @@ int mark_alt_bonds_and_taut_groups( struct tagINCHI_CLOCK   *ic,
     LOG_NO_ARGS("\n#####################################################################################\n");
 
 
+#if ( BUILD_WITH_BNS_PRESCREEN == 1 )
+    /* v. 1.07+: leave the structure and t_group_info as the full procedure */
+    /* below would leave them when it finds nothing to change              */
+    if (bIsBnsNormalizationTrivial( at, num_atoms ) &&
+         !( t_group_info && ( *pbTautFlags & TG_FLAG_VARIABLE_PROTONS ) &&
+         ( *pbTautFlagsDone & ( TG_FLAG_FOUND_ISOTOPIC_ATOM_DONE | TG_FLAG_FOUND_ISOTOPIC_H_DONE ) ) ) &&
+         !( ( *pbTautFlags & TG_FLAG_VARIABLE_PROTONS ) && t_group_info &&
+         mark_at_type( at, num_atoms, nAtTypeTotals ) ))
+    {
+        if (t_group_info)
+        {
+            num = t_group_info->tni.nNumRemovedExplicitH;
+            memset( &t_group_info->tni, 0, sizeof( t_group_info->tni ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+            t_group_info->tni.nNumRemovedExplicitH = num;
+            if (( t_group_info->bTautFlags & TG_FLAG_TEST_TAUT__ATOMS ) &&
+                 AllocTGroupInfoTGroups( t_group_info, num_atoms ) < 0)
+            {
+                bError = BNS_OUT_OF_RAM;
+                goto exit_function;
+            }
+        }
+        remove_alt_bond_marks( at, num_atoms );
+        if (pCG)
+        {
+            pCG->m_RunStat.lNumPrescreened++;
+        }
+        goto exit_function;
+    }
+    if (pCG)
+    {
+        pCG->m_RunStat.lNumSearched++;
+    }
+#endif
+
 #ifdef FIX_AROM_RADICAL        /* Added 2011-05-09 IPl */
     for (i = 0; i < num_atoms; i++)
     {
@@ -5380,11 +5601,11 @@ int mark_alt_bonds_and_taut_groups( struct tagINCHI_CLOCK   *ic,
     */
 
     /* Allocate Balanced Network Data Strucures; replace Alternating bonds with Single */
-    if (( pBNS = AllocateAndInitBnStruct( at, num_atoms,
+    if (( pBNS = AllocateAndInitBnStruct( pCG, at, num_atoms,
                                           BNS_ADD_ATOMS, BNS_ADD_EDGES,
                                           max_altp, &num_changed_bonds ) )
          &&
-         ( pBD = AllocateAndInitBnData( pBNS->max_vertices ) ))
+         ( pBD = AllocateAndInitBnData( pCG, pBNS->max_vertices ) ))
     {
 
 
@@ -5931,8 +6152,8 @@ int mark_alt_bonds_and_taut_groups( struct tagINCHI_CLOCK   *ic,
 exit_function:
 
     /* djb-rwth: ignoring LLVM warning: variables used to store functions return values */
-    pBNS = DeAllocateBnStruct(pBNS);
-    pBD = DeAllocateBnData(pBD);
+    pBNS = ReleaseBnStruct(pCG, pBNS);
+    pBD = ReleaseBnData(pCG, pBD);
     /*#if ( MOVE_CHARGES == 1 )*/
     if (c_group_info)
     {
@@ -8153,7 +8374,6 @@ int SetRadEndpoints2( CANON_GLOBALS *pCG,
                 /* Later merge such sets */
                 if (NULL == VertSet.bitword)
                 {
-                    SetBitCreate( pCG );
                     if (!NodeSetCreate( pCG, &VertSet, pBNS->num_atoms, nNumRad ))
                     {
                         ret = BNS_OUT_OF_RAM; /* out of RAM */
@@ -8780,7 +9000,8 @@ reinit_BNS:
 
 
 /****************************************************************************/
-BN_STRUCT* AllocateAndInitBnStruct( inp_ATOM *at,
+BN_STRUCT* AllocateAndInitBnStruct( CANON_GLOBALS *pCG,
+                                    inp_ATOM *at,
                                     int num_atoms,
                                     int nMaxAddAtoms,
                                     int nMaxAddEdges,
@@ -8795,7 +9016,7 @@ BN_STRUCT* AllocateAndInitBnStruct( inp_ATOM *at,
 
     int i, j, k, n_edges, num_bonds, num_edges, f1, f2, edge_cap, edge_flow, st_flow; /* djb-rwth: removing redundant variables */
     int tot_st_cap, tot_st_flow;
-    int max_tg, max_edges, max_vertices, len_alt_path, max_iedges, num_altp;
+    int max_tg, max_edges, max_vertices, len_alt_path, max_iedges;
 #if ( BNS_RAD_SEARCH == 1 )
     int num_rad = 0;
 
@@ -8838,31 +9059,10 @@ BN_STRUCT* AllocateAndInitBnStruct( inp_ATOM *at,
     max_iedges = 2 * max_edges;
     len_alt_path = max_vertices + iALTP_HDR_LEN + 1; /* may overflow if an edge is traversed in 2 directions */
 
-    if (!( pBNS = (BN_STRUCT   *) inchi_calloc( 1, sizeof( BN_STRUCT ) ) ) ||
-         !( pBNS->edge = (BNS_EDGE    *) inchi_calloc( max_edges, sizeof( BNS_EDGE ) ) ) ||
-         !( pBNS->vert = (BNS_VERTEX  *) inchi_calloc( max_vertices, sizeof( BNS_VERTEX ) ) ) ||
-         !( pBNS->iedge = (BNS_IEDGE   *) inchi_calloc( max_iedges, sizeof( BNS_IEDGE ) ) ))
+    if (!( pBNS = AllocateBnStructArrays( pCG, max_vertices, max_edges, max_iedges, max_altp, len_alt_path ) ))
     {
-        return DeAllocateBnStruct( pBNS );
-    }
-    /* Alt path init */
-    for (num_altp = 0; num_altp < max_altp && num_altp < BN_MAX_ALTP; num_altp++)
-    {
-        if (!( pBNS->altp[num_altp] = (BNS_ALT_PATH*) inchi_calloc( len_alt_path, sizeof( BNS_ALT_PATH ) ) ))
-        {
-            return DeAllocateBnStruct( pBNS );
-        }
-        ALTP_ALLOCATED_LEN( pBNS->altp[num_altp] ) = len_alt_path;
-        pBNS->len_alt_path = len_alt_path;  /* ??? duplication ??? */
-                                            /* re-init */
-        ALTP_DELTA( pBNS->altp[num_altp] ) = 0;
-        ALTP_START_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
-        ALTP_END_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
-        ALTP_PATH_LEN( pBNS->altp[num_altp] ) = 0;
+        return NULL;
     }
-    pBNS->alt_path = NULL;
-    pBNS->num_altp = 0;
-    pBNS->max_altp = num_altp;
 
     /* Fill vertices (no connectivity) */
     pBNS->vert[0].iedge = pBNS->iedge;
@@ -9038,6 +9238,163 @@ BN_STRUCT* DeAllocateBnStruct( BN_STRUCT *pBNS )
 }
 
 
+/****************************************************************************
+ Per-thread pool of balanced network arrays (v. 1.07+)
+
+ Normalization allocates a BN_STRUCT and a BN_DATA for each component,
+ and structure restoration for each attempt; they are sized for the
+ worst case and used to be calloc'ed and freed every time.
+ With BUILD_WITH_BNS_POOL the arrays are instead kept in
+ pCG->m_pBnsPool, grown by at least one half when a larger network
+ comes, and only the length requested is re-initialized.
+ One BN_STRUCT and one BN_DATA can be taken from the pool at a time;
+ a network allocated while the pooled one is in use comes from the heap.
+ ReleaseBnStruct()/ReleaseBnData() accept either kind.
+****************************************************************************/
+static BNS_POOL *GetBnsPool( CANON_GLOBALS *pCG )
+{
+#if ( BUILD_WITH_BNS_POOL == 1 )
+    if (pCG && !pCG->m_pBnsPool)
+    {
+        pCG->m_pBnsPool = (BNS_POOL *) inchi_calloc( 1, sizeof( BNS_POOL ) );
+    }
+    return pCG ? pCG->m_pBnsPool : NULL;
+#else
+    return NULL;
+#endif
+}
+
+
+/****************************************************************************
+ Make pooled array p at least nLen elements long; returns NULL if out of RAM
+****************************************************************************/
+static void *BnsPoolReserve( BNS_POOL *pPool,
+                             void *p,
+                             int *pnLen,
+                             int nLen,
+                             size_t nSize )
+{
+    if (p && *pnLen >= nLen)
+    {
+        return p;
+    }
+    if (p)
+    {
+        inchi_free( p );
+    }
+    *pnLen = inchi_max( nLen, *pnLen + *pnLen / 2 );
+    *pnLen = inchi_max( *pnLen, 1 );
+    if (( p = inchi_malloc( (size_t) *pnLen * nSize ) ))
+    {
+        pPool->lNumAllocated++;
+    }
+    else
+    {
+        *pnLen = 0;
+    }
+
+    return p;
+}
+
+
+/****************************************************************************
+ Allocate zero-filled BN_STRUCT arrays of the given lengths (from the
+ pool if available) and initialize the alternating paths
+****************************************************************************/
+BN_STRUCT* AllocateBnStructArrays( CANON_GLOBALS *pCG,
+                                   int max_vertices,
+                                   int max_edges,
+                                   int max_iedges,
+                                   int max_altp,
+                                   int len_alt_path )
+{
+    BN_STRUCT *pBNS = NULL;
+    BNS_POOL  *pPool = GetBnsPool( pCG );
+    int        num_altp;
+
+    if (pPool && !pPool->bBnsInUse)
+    {
+        pPool->edge = (BNS_EDGE *) BnsPoolReserve( pPool, pPool->edge, &pPool->nLenEdge, max_edges, sizeof( BNS_EDGE ) );
+        pPool->vert = (BNS_VERTEX *) BnsPoolReserve( pPool, pPool->vert, &pPool->nLenVert, max_vertices, sizeof( BNS_VERTEX ) );
+        pPool->iedge = (BNS_IEDGE *) BnsPoolReserve( pPool, pPool->iedge, &pPool->nLenIedge, max_iedges, sizeof( BNS_IEDGE ) );
+        if (!pPool->edge || !pPool->vert || !pPool->iedge)
+        {
+            return NULL;
+        }
+        pBNS = &pPool->Bns;
+        memset( pBNS, 0, sizeof( *pBNS ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        pBNS->edge = pPool->edge;
+        pBNS->vert = pPool->vert;
+        pBNS->iedge = pPool->iedge;
+        memset( pBNS->edge, 0, max_edges * sizeof( pBNS->edge[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        memset( pBNS->vert, 0, max_vertices * sizeof( pBNS->vert[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        memset( pBNS->iedge, 0, max_iedges * sizeof( pBNS->iedge[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        for (num_altp = 0; num_altp < max_altp && num_altp < BN_MAX_ALTP; num_altp++)
+        {
+            pPool->altp[num_altp] = (BNS_ALT_PATH *) BnsPoolReserve( pPool, pPool->altp[num_altp], &pPool->nLenAltp[num_altp],
+                                                                     len_alt_path, sizeof( BNS_ALT_PATH ) );
+            if (!pPool->altp[num_altp])
+            {
+                return NULL;
+            }
+            pBNS->altp[num_altp] = pPool->altp[num_altp];
+            memset( pBNS->altp[num_altp], 0, len_alt_path * sizeof( BNS_ALT_PATH ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        }
+        pPool->bBnsInUse = 1;
+        pPool->lNumReused++;
+    }
+    else
+    {
+        if (!( pBNS = (BN_STRUCT   *) inchi_calloc( 1, sizeof( BN_STRUCT ) ) ) ||
+             !( pBNS->edge = (BNS_EDGE    *) inchi_calloc( max_edges, sizeof( BNS_EDGE ) ) ) ||
+             !( pBNS->vert = (BNS_VERTEX  *) inchi_calloc( max_vertices, sizeof( BNS_VERTEX ) ) ) ||
+             !( pBNS->iedge = (BNS_IEDGE   *) inchi_calloc( max_iedges, sizeof( BNS_IEDGE ) ) ))
+        {
+            return DeAllocateBnStruct( pBNS );
+        }
+        for (num_altp = 0; num_altp < max_altp && num_altp < BN_MAX_ALTP; num_altp++)
+        {
+            if (!( pBNS->altp[num_altp] = (BNS_ALT_PATH*) inchi_calloc( len_alt_path, sizeof( BNS_ALT_PATH ) ) ))
+            {
+                return DeAllocateBnStruct( pBNS );
+            }
+        }
+    }
+
+    /* Alt path init */
+    for (num_altp = 0; num_altp < max_altp && num_altp < BN_MAX_ALTP; num_altp++)
+    {
+        ALTP_ALLOCATED_LEN( pBNS->altp[num_altp] ) = len_alt_path;
+        pBNS->len_alt_path = len_alt_path;  /* ??? duplication ??? */
+                                            /* re-init */
+        ALTP_DELTA( pBNS->altp[num_altp] ) = 0;
+        ALTP_START_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
+        ALTP_END_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
+        ALTP_PATH_LEN( pBNS->altp[num_altp] ) = 0;
+    }
+    pBNS->alt_path = NULL;
+    pBNS->num_altp = 0;
+    pBNS->max_altp = num_altp;
+
+    return pBNS;
+}
+
+
+/****************************************************************************
+ Return BN_STRUCT to the pool or free it
+****************************************************************************/
+BN_STRUCT* ReleaseBnStruct( CANON_GLOBALS *pCG, BN_STRUCT *pBNS )
+{
+    if (pBNS && pCG && pCG->m_pBnsPool && pBNS == &pCG->m_pBnsPool->Bns)
+    {
+        pCG->m_pBnsPool->bBnsInUse = 0;
+        return NULL;
+    }
+
+    return DeAllocateBnStruct( pBNS );
+}
+
+
 /****************************************************************************/
 int ReInitBnStructAltPaths( BN_STRUCT *pBNS )
 {
@@ -9666,6 +10023,14 @@ BN_DATA *DeAllocateBnData( BN_DATA *pBD )
             inchi_free( pBD->RadEdges );
         }
 #endif
+        if (pBD->RescapVert)
+        {
+            inchi_free( pBD->RescapVert );
+        }
+        if (pBD->BaseVert)
+        {
+            inchi_free( pBD->BaseVert );
+        }
         inchi_free( pBD );
     }
 
@@ -9673,15 +10038,201 @@ BN_DATA *DeAllocateBnData( BN_DATA *pBD )
 }
 
 
+/****************************************************************************
+ Return BN_DATA to the pool or free it
+****************************************************************************/
+BN_DATA *ReleaseBnData( CANON_GLOBALS *pCG, BN_DATA *pBD )
+{
+    if (pBD && pCG && pCG->m_pBnsPool && pBD == &pCG->m_pBnsPool->Bd)
+    {
+        pCG->m_pBnsPool->bBdInUse = 0;
+        return NULL;
+    }
+
+    return DeAllocateBnData( pBD );
+}
+
+
+/****************************************************************************
+ Take zero-filled BN_DATA arrays from the pool
+****************************************************************************/
+static BN_DATA *BnsPoolTakeData( BNS_POOL *pPool, int max_num_vertices, int max_len_Pu_Pv )
+{
+    BN_DATA *pBD = &pPool->Bd;
+
+    pPool->BasePtr = (Vertex *) BnsPoolReserve( pPool, pPool->BasePtr, &pPool->nLenBasePtr, max_num_vertices, sizeof( Vertex ) );
+    pPool->SwitchEdge = (Edge *) BnsPoolReserve( pPool, pPool->SwitchEdge, &pPool->nLenSwitchEdge, max_num_vertices, sizeof( Edge ) );
+    pPool->Tree = (S_CHAR *) BnsPoolReserve( pPool, pPool->Tree, &pPool->nLenTree, max_num_vertices, sizeof( S_CHAR ) );
+    pPool->ScanQ = (Vertex *) BnsPoolReserve( pPool, pPool->ScanQ, &pPool->nLenScanQ, max_num_vertices, sizeof( Vertex ) );
+    pPool->Pu = (Vertex *) BnsPoolReserve( pPool, pPool->Pu, &pPool->nLenPu, max_len_Pu_Pv, sizeof( Vertex ) );
+    pPool->Pv = (Vertex *) BnsPoolReserve( pPool, pPool->Pv, &pPool->nLenPv, max_len_Pu_Pv, sizeof( Vertex ) );
+#if ( BNS_RAD_SEARCH == 1 )
+    pPool->RadEndpoints = (Vertex *) BnsPoolReserve( pPool, pPool->RadEndpoints, &pPool->nLenRadEndpoints, max_len_Pu_Pv, sizeof( Vertex ) );
+    pPool->RadEdges = (EdgeIndex *) BnsPoolReserve( pPool, pPool->RadEdges, &pPool->nLenRadEdges, max_len_Pu_Pv, sizeof( EdgeIndex ) );
+    if (!pPool->RadEndpoints || !pPool->RadEdges)
+    {
+        return NULL;
+    }
+#endif
+    pPool->RescapVert = (Vertex *) BnsPoolReserve( pPool, pPool->RescapVert, &pPool->nLenRescapVert, max_len_Pu_Pv, sizeof( Vertex ) );
+    pPool->BaseVert = (Vertex *) BnsPoolReserve( pPool, pPool->BaseVert, &pPool->nLenBaseVert, max_len_Pu_Pv, sizeof( Vertex ) );
+    if (!pPool->BasePtr || !pPool->SwitchEdge || !pPool->Tree || !pPool->ScanQ || !pPool->Pu || !pPool->Pv ||
+         !pPool->RescapVert || !pPool->BaseVert)
+    {
+        return NULL;
+    }
+    memset( pBD, 0, sizeof( *pBD ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    pBD->BasePtr = pPool->BasePtr;
+    pBD->SwitchEdge = pPool->SwitchEdge;
+    pBD->Tree = pPool->Tree;
+    pBD->ScanQ = pPool->ScanQ;
+    pBD->Pu = pPool->Pu;
+    pBD->Pv = pPool->Pv;
+    pBD->RescapVert = pPool->RescapVert;
+    pBD->BaseVert = pPool->BaseVert;
+    /* BasePtr and Tree are initialized by the caller, SwitchEdge only in part */
+    memset( pBD->SwitchEdge, 0, max_num_vertices * sizeof( pBD->SwitchEdge[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset( pBD->ScanQ, 0, max_num_vertices * sizeof( pBD->ScanQ[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset( pBD->Pu, 0, max_len_Pu_Pv * sizeof( pBD->Pu[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset( pBD->Pv, 0, max_len_Pu_Pv * sizeof( pBD->Pv[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+#if ( BNS_RAD_SEARCH == 1 )
+    pBD->RadEndpoints = pPool->RadEndpoints;
+    pBD->RadEdges = pPool->RadEdges;
+    memset( pBD->RadEndpoints, 0, max_len_Pu_Pv * sizeof( pBD->RadEndpoints[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset( pBD->RadEdges, 0, max_len_Pu_Pv * sizeof( pBD->RadEdges[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+#endif
+    pPool->bBdInUse = 1;
+    pPool->lNumReused++;
+
+    return pBD;
+}
+
+
 /****************************************************************************/
-BN_DATA *AllocateAndInitBnData( int max_num_vertices )
+void BnsPoolFree( CANON_GLOBALS *pCG )
 {
-    BN_DATA *pBD = NULL;
-    int      max_len_Pu_Pv;
+    BNS_POOL *pPool = pCG->m_pBnsPool;
+    int       i;
+
+    if (!pPool)
+    {
+        return;
+    }
+    if (pPool->edge)
+    {
+        inchi_free( pPool->edge );
+    }
+    if (pPool->vert)
+    {
+        inchi_free( pPool->vert );
+    }
+    if (pPool->iedge)
+    {
+        inchi_free( pPool->iedge );
+    }
+    for (i = 0; i < BN_MAX_ALTP; i++)
+    {
+        if (pPool->altp[i])
+        {
+            inchi_free( pPool->altp[i] );
+        }
+    }
+    if (pPool->BasePtr)
+    {
+        inchi_free( pPool->BasePtr );
+    }
+    if (pPool->SwitchEdge)
+    {
+        inchi_free( pPool->SwitchEdge );
+    }
+    if (pPool->Tree)
+    {
+        inchi_free( pPool->Tree );
+    }
+    if (pPool->ScanQ)
+    {
+        inchi_free( pPool->ScanQ );
+    }
+    if (pPool->Pu)
+    {
+        inchi_free( pPool->Pu );
+    }
+    if (pPool->Pv)
+    {
+        inchi_free( pPool->Pv );
+    }
+#if ( BNS_RAD_SEARCH == 1 )
+    if (pPool->RadEndpoints)
+    {
+        inchi_free( pPool->RadEndpoints );
+    }
+    if (pPool->RadEdges)
+    {
+        inchi_free( pPool->RadEdges );
+    }
+#endif
+    if (pPool->RescapVert)
+    {
+        inchi_free( pPool->RescapVert );
+    }
+    if (pPool->BaseVert)
+    {
+        inchi_free( pPool->BaseVert );
+    }
+    inchi_free( pPool );
+    pCG->m_pBnsPool = NULL;
+}
+
+
+/****************************************************************************
+ Add the processing statistics of a helper thread (v. 1.07+)
+****************************************************************************/
+void RunStatAdd( RUN_STAT *pTo, const RUN_STAT *pFrom )
+{
+    pTo->lNumPrescreened += pFrom->lNumPrescreened;
+    pTo->lNumSearched += pFrom->lNumSearched;
+    pTo->lNumRecordsPrescreened += pFrom->lNumRecordsPrescreened;
+    pTo->lNumArenaAllocs += pFrom->lNumArenaAllocs;
+    pTo->lNumArenaHeapAllocs += pFrom->lNumArenaHeapAllocs;
+    pTo->nArenaSize = inchi_max( pTo->nArenaSize, pFrom->nArenaSize );
+    pTo->lNumBnsReused += pFrom->lNumBnsReused;
+    pTo->lNumBnsAllocated += pFrom->lNumBnsAllocated;
+    pTo->lNumStereoMappings += pFrom->lNumStereoMappings;
+}
+
+
+/****************************************************************************
+ Add the statistics of pCG, including those kept by its scratch arena
+ and balanced network pool, before pCG is freed (v. 1.07+)
+****************************************************************************/
+void RunStatAddCG( RUN_STAT *pTo, const CANON_GLOBALS *pCG )
+{
+    RunStatAdd( pTo, &pCG->m_RunStat );
+    pTo->lNumArenaAllocs += pCG->m_Arena.lNumArenaAllocs;
+    pTo->lNumArenaHeapAllocs += pCG->m_Arena.lNumHeapAllocs;
+    pTo->nArenaSize = inchi_max( pTo->nArenaSize, pCG->m_Arena.nSize );
+    if (pCG->m_pBnsPool)
+    {
+        pTo->lNumBnsReused += pCG->m_pBnsPool->lNumReused;
+        pTo->lNumBnsAllocated += pCG->m_pBnsPool->lNumAllocated;
+    }
+}
+
+
+/****************************************************************************/
+BN_DATA *AllocateAndInitBnData( CANON_GLOBALS *pCG, int max_num_vertices )
+{
+    BN_DATA  *pBD = NULL;
+    BNS_POOL *pPool = GetBnsPool( pCG );
+    int       max_len_Pu_Pv;
     max_num_vertices = 2 * max_num_vertices + 2;
     max_len_Pu_Pv = max_num_vertices / 2 + 1;
     max_len_Pu_Pv += max_len_Pu_Pv % 2; /* even length */
-    if (!( pBD = (BN_DATA *) inchi_calloc( 1, sizeof( BN_DATA ) ) ) ||
+    if (pPool && !pPool->bBdInUse)
+    {
+        pBD = BnsPoolTakeData( pPool, max_num_vertices, max_len_Pu_Pv );
+    }
+    else if (!( pBD = (BN_DATA *) inchi_calloc( 1, sizeof( BN_DATA ) ) ) ||
          !( pBD->BasePtr = (Vertex *) inchi_calloc( max_num_vertices, sizeof( Vertex ) ) ) ||
          !( pBD->SwitchEdge = (Edge   *) inchi_calloc( max_num_vertices, sizeof( Edge ) ) ) ||
          !( pBD->Tree = (S_CHAR *) inchi_calloc( max_num_vertices, sizeof( S_CHAR ) ) ) ||
@@ -9691,12 +10242,14 @@ BN_DATA *AllocateAndInitBnData( int max_num_vertices )
          !( pBD->RadEndpoints = (Vertex *) inchi_calloc( max_len_Pu_Pv, sizeof( Vertex ) ) ) ||
          !( pBD->RadEdges = (EdgeIndex*) inchi_calloc( max_len_Pu_Pv, sizeof( EdgeIndex ) ) ) ||
 #endif
-         !( pBD->Pv = (Vertex *) inchi_calloc( max_len_Pu_Pv, sizeof( Vertex ) ) )
+         !( pBD->Pv = (Vertex *) inchi_calloc( max_len_Pu_Pv, sizeof( Vertex ) ) ) ||
+         !( pBD->RescapVert = (Vertex *) inchi_calloc( max_len_Pu_Pv, sizeof( Vertex ) ) ) ||
+         !( pBD->BaseVert = (Vertex *) inchi_calloc( max_len_Pu_Pv, sizeof( Vertex ) ) )
          )
     {
         pBD = DeAllocateBnData( pBD );
     }
-    else
+    if (pBD)
     {
         /* Initialize data */
         ClearAllBnDataEdges( pBD->SwitchEdge, NO_VERTEX, max_num_vertices );
@@ -9708,6 +10261,7 @@ BN_DATA *AllocateAndInitBnData( int max_num_vertices )
 #if ( BNS_RAD_SEARCH == 1 )
         pBD->nNumRadEndpoints = 0;
 #endif
+        pBD->nNumRescapVert = -1;
     }
 
     return pBD;
@@ -10790,8 +11344,13 @@ int BalancedNetworkSearch( BN_STRUCT* pBNS, BN_DATA *pBD, int bChangeFlow )
 
     /* added to translate into C */
     int i, k, degree, delta, ret = 0;
-    Vertex u, b_u, v, b_v, w;
+    Vertex u, b_u, v, b_v, w, iv;
     EdgeIndex iuv;
+    BNS_VERTEX  *pVert;     /* v. 1.07+: the atom of vertex u; NULL if u is s or t */
+    Vertex      *pRootVert; /* v. 1.07+: the only neighbors of u = s to check; NULL => all */
+    BNS_EDGE    *pEdge;     /* edge uv if v is an atom vertex */
+    BNS_ST_EDGE *pStEdge;   /* edge uv if u or v is s or t */
+    int          bBackward; /* the direction of pStEdge */
 #if ( BNS_RAD_SEARCH == 1 )
     int              n, bRadSearch = ( BNS_EF_RAD_SRCH & bChangeFlow ) && pBD->RadEndpoints;
     BRS_MODE         bRadSrchMode = RAD_SRCH_NORM;
@@ -10819,17 +11378,67 @@ int BalancedNetworkSearch( BN_STRUCT* pBNS, BN_DATA *pBD, int bChangeFlow )
         u = ScanQ[k]; /* select u from the head of ScanQ */
                       /* since u is on the queue, it has a blossom C(U) with base b_u */
         b_u = FindBase( u, BasePtr );
-        degree = GetVertexDegree( pBNS, u );
+        /* degree = GetVertexDegree( pBNS, u ); */
+        if (u >= 2)
+        {
+            pVert = pBNS->vert + ( u / 2 - 1 );
+            degree = ( pVert->st_edge.cap > 0 ) ? pVert->num_adj_edges + 1 : 0;
+        }
+        else
+        {
+            pVert = NULL;
+            degree = pBNS->num_vertices;
+        }
+        pRootVert = NULL;
+#if ( BUILD_WITH_BNS_WARM_START == 1 )
+        if (u == Vertex_s && pBD->nNumRescapVert >= 0)
+        {
+            pRootVert = pBD->RescapVert;
+            degree = pBD->nNumRescapVert;
+        }
+#endif
 #if ( BNS_RAD_SEARCH == 1 )
         n = 0;
 #endif
         for (i = 0; i < degree; i++)
         {
             /* v = vert[u].neighbor[i]; */
-            v = GetVertexNeighbor( pBNS, u, i, &iuv );
-            if (v == NO_VERTEX)
+            /* v = GetVertexNeighbor( pBNS, u, i, &iuv ); */
+            if (!pVert)
+            {
+                /* neighbor of s or t: x or y, same parity as u */
+                iv = pRootVert ? pRootVert[i] : i;
+                pStEdge = &pBNS->vert[iv].st_edge;
+                if (!( pStEdge->cap & EDGE_FLOW_ST_MASK ))
+                {
+                    continue;
+                }
+                pEdge = NULL;
+                bBackward = ( u & 1 );
+                v = 2 * iv + 2 + ( u & 1 );
+                iuv = -( v + 1 );
+            }
+            else if (!i)
             {
-                continue; /* the atom has only single bonds, ignore it */
+                /* neighbor of x or y is s or t, same parity as u */
+                pStEdge = &pVert->st_edge;
+                pEdge = NULL;
+                v = ( u & 1 );
+                bBackward = !v;
+                iuv = -( v + 1 );
+            }
+            else
+            {
+                /* neighbor of x or y is y or x */
+                iuv = pVert->iedge[i - 1];
+                pEdge = pBNS->edge + iuv;
+                if (!( pEdge->cap & EDGE_FLOW_MASK ) || IS_FORBIDDEN( pEdge->forbidden, pBNS ))
+                {
+                    continue; /* the atom has only single bonds, ignore it */
+                }
+                pStEdge = NULL;
+                bBackward = 0;
+                v = BNS_ATOM_NEIGHBOR( u, pEdge );
             }
 #if ( BNS_RAD_SEARCH == 1 )
             if (!k && bRadSrchMode == RAD_SRCH_FROM_FICT && v / 2 <= pBNS->num_atoms)
@@ -10843,7 +11452,7 @@ int BalancedNetworkSearch( BN_STRUCT* pBNS, BN_DATA *pBD, int bChangeFlow )
 #endif
             if ( /* PrevPt[u] != v ** avoid edges of T */
                 ( SwitchEdge_Vert1( u ) != v || SwitchEdge_Vert2( u ) != u )  /* avoid edges of T */
-                 && ( ret = rescap( pBNS, u, v, iuv ) ) > 0)
+                 && ( ret = pEdge ? BNS_ATOM_RESCAP( u, pEdge ) : BNS_ST_RESCAP( pStEdge, bBackward ) ) > 0)
             {
                 /* Special treatment to prevent H<->(-) replacement on non-acidic atoms */
                 /*----------------------------------------------------------------------*/
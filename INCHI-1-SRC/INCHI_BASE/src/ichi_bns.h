@@ -301,8 +301,58 @@ typedef struct BalancedNetworkData {
     int             nNumRadicals;
     BRS_MODE        bRadSrchMode; /* 1 => connect fict. vertices-radicals to the accessible atoms */
 #endif
+    /* v. 1.07+: ascending numbers of the vertices whose st-edges may have residual capacity;  */
+    /* if nNumRescapVert >= 0 then the search from s looks only at them (BUILD_WITH_BNS_WARM_START) */
+    Vertex         *RescapVert;  /*[MAX_VERTEX/2+1] */
+    int             nNumRescapVert; /* -1 => not known; scan all vertices */
+    Vertex         *BaseVert;    /*[MAX_VERTEX/2+1] RescapVert[] saved by BnsTestAndMarkAltBonds() */
 } BN_DATA;
 
+/********************* BNS_POOL ******************************************/
+/* v. 1.07+: arrays of one BN_STRUCT and one BN_DATA kept per CANON_GLOBALS */
+/* (i.e. per thread) and reused by subsequent networks; they are grown      */
+/* geometrically and only the length requested is re-initialized          */
+typedef struct tagBnsPool {
+    BN_STRUCT       Bns;                /* handed out by AllocateBnStructArrays() */
+    BNS_EDGE       *edge;
+    BNS_VERTEX     *vert;
+    BNS_IEDGE      *iedge;
+    BNS_ALT_PATH   *altp[BN_MAX_ALTP];
+    int             nLenEdge;           /* allocated lengths */
+    int             nLenVert;
+    int             nLenIedge;
+    int             nLenAltp[BN_MAX_ALTP];
+    int             bBnsInUse;
+
+    BN_DATA         Bd;                 /* handed out by AllocateAndInitBnData() */
+    Vertex         *BasePtr;
+    Edge           *SwitchEdge;
+    S_CHAR         *Tree;
+    Vertex         *ScanQ;
+    Vertex         *Pu;
+    Vertex         *Pv;
+    int             nLenBasePtr;        /* allocated lengths */
+    int             nLenSwitchEdge;
+    int             nLenTree;
+    int             nLenScanQ;
+    int             nLenPu;
+    int             nLenPv;
+#if ( BNS_RAD_SEARCH == 1 )
+    Vertex         *RadEndpoints;
+    EdgeIndex      *RadEdges;
+    int             nLenRadEndpoints;
+    int             nLenRadEdges;
+#endif
+    Vertex         *RescapVert;
+    Vertex         *BaseVert;
+    int             nLenRescapVert;
+    int             nLenBaseVert;
+    int             bBdInUse;
+
+    long            lNumReused;         /* BN_STRUCT/BN_DATA served from the pool */
+    long            lNumAllocated;      /* pooled arrays that had to be (re)allocated */
+} BNS_POOL;
+
 /* internal array size */
 #define MAX_ALT_AATG_ARRAY_LEN 127
 /* detected endpoint markings */
@@ -374,8 +424,20 @@ typedef struct tagBNS_FLOW_CHANGES {
 #define ALT_PATH_MODE_TAUTOM_PT_18_00 16
 #endif
 
-typedef U_SHORT  bitWord;
+/* v. 1.07+: 64-bit set words; bit j lives in word BitWordIndex(j) under mask */
+/* BitWordBit(j), and the members of a set word are enumerated with           */
+/* count-trailing-zeros rather than by probing every bit via pCG->m_bBit[]    */
+typedef unsigned long long bitWord;
 #define BIT_WORD_MASK  ((bitWord)~0)
+#define BIT_WORD_BITS  64
+#define BIT_WORD_SHIFT 6
+#define BitWordIndex( j )  ( (j) >> BIT_WORD_SHIFT )
+#define BitWordBit( j )    ( (bitWord) 1 << ( (j) & ( BIT_WORD_BITS - 1 ) ) )
+#if ( defined(__GNUC__) || defined(__clang__) )
+#define BitWordCtz( w )    __builtin_ctzll( w )
+#else
+#define BIT_WORD_PORTABLE_CTZ
+#endif
 
 typedef struct tagNodeSet {
     bitWord **bitword;
@@ -421,6 +483,9 @@ extern "C" {
 
     struct tagCANON_GLOBALS;
 
+#ifdef BIT_WORD_PORTABLE_CTZ
+    int  BitWordCtz( bitWord w );
+#endif
     int  NodeSetCreate( struct tagCANON_GLOBALS *pCG, NodeSet *pSet, int n, int L );
     void NodeSetFree( struct tagCANON_GLOBALS *pCG, NodeSet *pSet );
 
@@ -469,14 +534,17 @@ extern "C" {
 
     /* moved from ichi_bns.c 2005-08-23 */
     int RunBalancedNetworkSearch( BN_STRUCT *pBNS, BN_DATA *pBD, int bChangeFlow );
-    BN_STRUCT* AllocateAndInitBnStruct( inp_ATOM *at, int num_atoms, int nMaxAddAtoms, int nMaxAddEdges, int max_altp, int *num_changed_bonds );
+    BN_STRUCT* AllocateAndInitBnStruct( struct tagCANON_GLOBALS *pCG, inp_ATOM *at, int num_atoms, int nMaxAddAtoms, int nMaxAddEdges, int max_altp, int *num_changed_bonds );
+    BN_STRUCT* AllocateBnStructArrays( struct tagCANON_GLOBALS *pCG, int max_vertices, int max_edges, int max_iedges, int max_altp, int len_alt_path );
     BN_STRUCT* DeAllocateBnStruct( BN_STRUCT *pBNS );
+    BN_STRUCT* ReleaseBnStruct( struct tagCANON_GLOBALS *pCG, BN_STRUCT *pBNS );
     int ReInitBnStructAltPaths( BN_STRUCT *pBNS );
     int ReInitBnStructForMoveableAltBondTest( BN_STRUCT *pBNS, inp_ATOM *at, int num_atoms );
     void ClearAllBnDataVertices( Vertex *v, Vertex value, int size );
     void ClearAllBnDataEdges( Edge *e, Vertex value, int size );
     BN_DATA *DeAllocateBnData( BN_DATA *pBD );
-    BN_DATA *AllocateAndInitBnData( int max_num_vertices );
+    BN_DATA *ReleaseBnData( struct tagCANON_GLOBALS *pCG, BN_DATA *pBD );
+    BN_DATA *AllocateAndInitBnData( struct tagCANON_GLOBALS *pCG, int max_num_vertices );
     int ReInitBnData( BN_DATA *pBD );
     int SetForbiddenEdges( BN_STRUCT *pBNS, inp_ATOM *at, int num_atoms, int edge_forbidden_mask,
                            int nebend, int *ebend );
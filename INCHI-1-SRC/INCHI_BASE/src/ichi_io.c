@@ -38,7 +38,15 @@
  *
 */
 
+#if ( !defined(_WIN32) && !defined(_POSIX_C_SOURCE) )
+#define _POSIX_C_SOURCE 200809L /* v. 1.07+: fileno(), fseeko(), ftello() */
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64    /* v. 1.07+: 64-bit off_t on 32-bit systems */
+#endif
+
 #include <string.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdarg.h>
@@ -46,12 +54,25 @@
 
 #include "mode.h"
 #include "ichi_io.h"
+
+#if ( BUILD_WITH_MMAP == 1 )
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
 #include "ichicomp.h"
 #include "ichidrp.h"
 #include "strutil.h"
 #include "util.h"
 
 #include "bcf_s.h"
+#include "stb_sprintf.h"
 
 #ifndef INCHI_ADD_STR_LEN
 #define INCHI_ADD_STR_LEN   32768
@@ -66,10 +87,8 @@ extern void(*FWPUSH) (const char* s);
 
 /* Internal functions */
 
-int inchi_ios_str_getc(INCHI_IOSTREAM* ios);
 char* inchi_ios_str_gets(char* szLine, int len, INCHI_IOSTREAM* ios);
 char* inchi_ios_str_getsTab(char* szLine, int len, INCHI_IOSTREAM* ios);
-int GetMaxPrintfLength(const char* lpszFormat, va_list argList);
 char* inchi_fgetsTab(char* szLine, int len, FILE* f);
 int inchi_vfprintf(FILE* f, const char* lpszFormat, va_list argList);
 
@@ -79,6 +98,23 @@ int inchi_vfprintf(FILE* f, const char* lpszFormat, va_list argList);
 */
 
 
+/* Memory mapped input file (INCHI_IOS_TYPE_MMAP) */
+typedef struct tagInchiIosMmap
+{
+    const char *pData;          /* contents of the file */
+    size_t     nLen;
+    size_t     nPos;            /* current read position */
+#if ( BUILD_WITH_MMAP == 1 && defined(_WIN32) )
+    HANDLE     hMap;
+#endif
+} INCHI_IOS_MMAP;
+
+static void inchi_ios_unmap( INCHI_IOSTREAM* ios );
+static int inchi_strbuf_reserve( INCHI_IOS_STRING* buf, int n );
+static int inchi_strbuf_vprintf( INCHI_IOS_STRING* buf, const char* lpszFormat, va_list argList );
+static int inchi_strbuf_has_float_format( const char* lpszFormat );
+
+
 /****************************************************************************
  Init INCHI_IOSTREAM
 ****************************************************************************/
@@ -232,6 +268,7 @@ void inchi_ios_close(INCHI_IOSTREAM* ios)
     {
         return;
     }
+    inchi_ios_unmap(ios);
     if (ios->s.pStr)
     {
         inchi_free(ios->s.pStr);
@@ -254,6 +291,7 @@ void inchi_ios_close(INCHI_IOSTREAM* ios)
 ****************************************************************************/
 void inchi_ios_reset(INCHI_IOSTREAM* ios)
 {
+    inchi_ios_unmap(ios);
     ios->s.pStr = NULL;
     ios->s.nUsedLength = ios->s.nAllocatedLength = ios->s.nPtr = 0;
     if (NULL != ios->f && stdout != ios->f && stderr != ios->f && stdin != ios->f)
@@ -265,6 +303,141 @@ void inchi_ios_reset(INCHI_IOSTREAM* ios)
 }
 
 
+/****************************************************************************
+    Map the input file of INCHI_IOS_TYPE_FILE stream into memory; the
+    stream becomes INCHI_IOS_TYPE_MMAP and is read from the current file
+    position on. The file remains open.
+    Returns 0 on success, -1 if the stream is left unchanged.
+****************************************************************************/
+int inchi_ios_mmap(INCHI_IOSTREAM* ios)
+{
+#if ( BUILD_WITH_MMAP == 1 )
+    INCHI_IOS_MMAP* m;
+    long long pos;
+
+    if (!ios || ios->type != INCHI_IOS_TYPE_FILE || !ios->f || ios->f == stdin ||
+        0 > (pos = inchi_ftell64(ios->f)))
+    {
+        return -1;
+    }
+    if (!(m = (INCHI_IOS_MMAP*)inchi_calloc(1, sizeof(*m))))
+    {
+        return -1;
+    }
+#if defined(_WIN32)
+    {
+        HANDLE hFile = (HANDLE)_get_osfhandle(_fileno(ios->f));
+        LARGE_INTEGER size;
+        if (hFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(hFile, &size) ||
+            size.QuadPart <= 0 || (unsigned long long) size.QuadPart > (size_t)-1 ||
+            !(m->hMap = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL)))
+        {
+            inchi_free(m);
+            return -1;
+        }
+        if (!(m->pData = (const char*)MapViewOfFile(m->hMap, FILE_MAP_READ, 0, 0, 0)))
+        {
+            CloseHandle(m->hMap);
+            inchi_free(m);
+            return -1;
+        }
+        m->nLen = (size_t)size.QuadPart;
+    }
+#else
+    {
+        struct stat st;
+        void* p;
+        if (fstat(fileno(ios->f), &st) || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+            (unsigned long long) st.st_size > (size_t)-1 ||
+            MAP_FAILED == (p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(ios->f), 0)))
+        {
+            inchi_free(m);
+            return -1;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+        m->pData = (const char*)p;
+        m->nLen = (size_t)st.st_size;
+    }
+#endif
+    m->nPos = inchi_min((size_t)pos, m->nLen);
+    ios->m = m;
+    ios->type = INCHI_IOS_TYPE_MMAP;
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+
+/****************************************************************************
+    Release the mapping of INCHI_IOS_TYPE_MMAP stream (the file is not
+    closed); the stream becomes INCHI_IOS_TYPE_FILE
+****************************************************************************/
+static void inchi_ios_unmap(INCHI_IOSTREAM* ios)
+{
+    if (ios->type != INCHI_IOS_TYPE_MMAP)
+    {
+        return;
+    }
+    if (ios->m)
+    {
+#if ( BUILD_WITH_MMAP == 1 && defined(_WIN32) )
+        UnmapViewOfFile((LPCVOID)ios->m->pData);
+        CloseHandle(ios->m->hMap);
+#elif ( BUILD_WITH_MMAP == 1 )
+        munmap((void*)ios->m->pData, ios->m->nLen);
+#endif
+        inchi_free(ios->m);
+        ios->m = NULL;
+    }
+    ios->type = INCHI_IOS_TYPE_FILE;
+}
+
+
+/****************************************************************************
+    Current read position of input file stream (as ftell)
+****************************************************************************/
+long long inchi_ios_tell(INCHI_IOSTREAM* ios)
+{
+    if (ios->type == INCHI_IOS_TYPE_MMAP && ios->m)
+    {
+        return (long long)ios->m->nPos;
+    }
+    if (ios->type == INCHI_IOS_TYPE_FILE && ios->f)
+    {
+        return inchi_ftell64(ios->f);
+    }
+
+    return -1LL;
+}
+
+
+/****************************************************************************
+    Set read position of input file stream (as fseek with SEEK_SET)
+****************************************************************************/
+int inchi_ios_seek(INCHI_IOSTREAM* ios, long long pos)
+{
+    if (ios->type == INCHI_IOS_TYPE_MMAP && ios->m)
+    {
+        if (pos < 0LL || (unsigned long long)pos > ios->m->nLen)
+        {
+            return -1;
+        }
+        ios->m->nPos = (size_t)pos;
+        return 0;
+    }
+    if (ios->type == INCHI_IOS_TYPE_FILE && ios->f)
+    {
+        return inchi_fseek64(ios->f, pos);
+    }
+
+    return -1;
+}
+
+
 /****************************************************************************
     Reset INCHI_IOSTREAM: set string buffer ptr to NULL
     (after freeing memory) but do not close associated file.
@@ -303,6 +476,15 @@ int inchi_ios_str_getc(INCHI_IOSTREAM* ios)
         return EOF;
     }
 
+    else if (ios->type == INCHI_IOS_TYPE_MMAP && ios->m)
+    {
+        if (ios->m->nPos < ios->m->nLen)
+        {
+            return (int)(unsigned char)ios->m->pData[ios->m->nPos++]; /* as fgetc */
+        }
+        return EOF;
+    }
+
     else if (ios->type == INCHI_IOS_TYPE_FILE)
     {
         c = fgetc(ios->f);
@@ -487,58 +669,20 @@ int inchi_ios_print(INCHI_IOSTREAM* ios, const char* lpszFormat, ...)
     if (ios->type == INCHI_IOS_TYPE_STRING)
     {
         /* output to string buffer */
-        int max_len;
         my_va_start(argList, lpszFormat);
-        max_len = GetMaxPrintfLength(lpszFormat, argList);
+        ret = inchi_strbuf_vprintf(&ios->s, lpszFormat, argList);
         va_end(argList);
-        if (max_len >= 0)
+#ifdef TARGET_LIB_FOR_WINCHI
+#if 0
+        if (FWPRINT)
         {
-            /* djb-rwth: fixing oss-fuzz issue #30152 */
-            int  nAddLength = inchi_max(INCHI_ADD_STR_LEN, max_len);
-            long long new_str_len = (long long)ios->s.nAllocatedLength + (long long)nAddLength;
-            if (ios->s.nAllocatedLength - ios->s.nUsedLength <= max_len)
-            {
-                /* enlarge output string */
-                char* new_str = (char*)inchi_calloc(new_str_len, sizeof(char)); /* djb-rwth: cast operators added */
-                if (new_str)
-                {
-                    if (ios->s.pStr)
-                    {
-                        if (ios->s.nUsedLength > 0)
-                        {
-                            memcpy(new_str, ios->s.pStr, sizeof(new_str[0]) * ios->s.nUsedLength);
-                        }
-                        inchi_free(ios->s.pStr);
-                    }
-                    ios->s.pStr = new_str;
-                    ios->s.nAllocatedLength += nAddLength;
-                }
-                else
-                {
-                    return -1; /* failed */
-                }
-            }
-            /* output */
             my_va_start(argList, lpszFormat);
-            ret = vsprintf(ios->s.pStr + ios->s.nUsedLength, lpszFormat, argList); /* djb-rwth: not using vsnprintf due to variable length argument */
+            FWPRINT(lpszFormat, argList);
             va_end(argList);
-            if (ret >= 0)
-            {
-                ios->s.nUsedLength += ret;
-            }
-#ifdef TARGET_LIB_FOR_WINCHI
-#if 0
-            if (FWPRINT)
-            {
-                my_va_start(argList, lpszFormat);
-                FWPRINT(lpszFormat, argList);
-                va_end(argList);
-            }
+        }
 #endif
 #endif
-            return ret;
-        }
-        return -1;
+        return ret;
     }
 
     else if (ios->type == INCHI_IOS_TYPE_FILE)
@@ -615,49 +759,11 @@ int inchi_ios_print_nodisplay( INCHI_IOSTREAM * ios,
     if (ios->type == INCHI_IOS_TYPE_STRING)
     {
         /* output to string buffer */
-        int ret = 0, max_len;
+        int ret;
         my_va_start( argList, lpszFormat );
-        max_len = GetMaxPrintfLength( lpszFormat, argList );
+        ret = inchi_strbuf_vprintf( &ios->s, lpszFormat, argList );
         va_end( argList );
-        if (max_len >= 0)
-        {
-            /* djb-rwth: fixing oss-fuzz issue #30163 */
-            int  nAddLength = inchi_max(INCHI_ADD_STR_LEN, max_len);
-            long long new_str_len = (long long)ios->s.nAllocatedLength + (long long)nAddLength;
-            if (ios->s.nAllocatedLength - ios->s.nUsedLength <= max_len)
-            {
-                /* enlarge output string */
-                char* new_str = (char*)inchi_calloc(new_str_len, sizeof(new_str[0])); /* djb-rwth: cast operators added */
-                if (new_str)
-                {
-                    if (ios->s.pStr)
-                    {
-                        if (ios->s.nUsedLength > 0)
-                        {
-                            memcpy( new_str, ios->s.pStr, sizeof( new_str[0] )*ios->s.nUsedLength );
-                        }
-                        inchi_free( ios->s.pStr );
-                    }
-                    ios->s.pStr = new_str;
-                    ios->s.nAllocatedLength += nAddLength;
-                }
-                else
-                {
-                    return -1; /* failed */
-                }
-            }
-            /* output */
-            /* djb-rwth: fixing oss-fuzz issue #67676 */
-            my_va_start(argList, lpszFormat);
-            ret = vsprintf(ios->s.pStr + ios->s.nUsedLength, lpszFormat, argList); /* djb-rwth: not using vsnprintf due to variable length argument; fixing GHI #71 */
-            va_end(argList);
-            if (ret >= 0)
-            {
-                ios->s.nUsedLength += ret;
-            }
-            return ret;
-        }
-        return -1;
+        return ret;
     }
 
     else if (ios->type == INCHI_IOS_TYPE_FILE)
@@ -719,50 +825,10 @@ int inchi_ios_eprint(INCHI_IOSTREAM* ios, const char* lpszFormat, ...)
         /* was #if ( defined(TARGET_API_LIB) || defined(INCHI_STANDALONE_EXE) ) */
     {
         /* output to string buffer */
-        int max_len, nAddLength = 0;
-        char* new_str = NULL;
-
         my_va_start(argList, lpszFormat);
-        max_len = GetMaxPrintfLength(lpszFormat, argList);
+        ret = inchi_strbuf_vprintf(&ios->s, lpszFormat, argList);
         va_end(argList);
-
-        if (max_len >= 0)
-        {
-            if (ios->s.nAllocatedLength - ios->s.nUsedLength <= max_len)
-            {
-                /* enlarge output string */
-                nAddLength = inchi_max(INCHI_ADD_STR_LEN, max_len);
-                new_str = (char*)inchi_calloc((long long)ios->s.nAllocatedLength + (long long)nAddLength, sizeof(new_str[0])); /* djb-rwth: cast operators added */
-                if (new_str)
-                {
-                    if (ios->s.pStr)
-                    {
-                        if (ios->s.nUsedLength > 0)
-                        {
-                            memcpy(new_str, ios->s.pStr, sizeof(new_str[0]) * ios->s.nUsedLength);
-                        }
-                        inchi_free(ios->s.pStr);
-                    }
-                    ios->s.pStr = new_str;
-                    ios->s.nAllocatedLength += nAddLength;
-                }
-                else
-                {
-                    return -1; /* failed */
-                }
-            }
-
-            /* output */
-            my_va_start(argList, lpszFormat);
-            ret = vsprintf(ios->s.pStr + ios->s.nUsedLength, lpszFormat, argList);
-            va_end(argList);
-            if (ret >= 0)
-            {
-                ios->s.nUsedLength += ret;
-            }
-            return ret;
-        }
-        return -1;
+        return ret;
     }
 
     else if (ios->type == INCHI_IOS_TYPE_FILE)
@@ -1014,6 +1080,24 @@ char* inchi_fgetsLf(char* line, int line_len, INCHI_IOSTREAM* inp_stream)
             }
         }
     }
+    else if (inp_stream->type == INCHI_IOS_TYPE_MMAP && inp_stream->m)
+    {
+        /* Read from mapped file: same result as from the file, */
+        /* the rest of too long line is skipped                 */
+        INCHI_IOS_MMAP* m = inp_stream->m;
+        size_t len = 0, left = m->nLen - m->nPos;
+        if (left && line_len > 1)
+        {
+            const char* start = m->pData + m->nPos;
+            const char* end = (const char*)memchr(start, '\n', left);
+            size_t n = end ? (size_t)(end - start) + 1 : left;
+            len = inchi_min(n, (size_t)line_len - 1);
+            memcpy(line, start, len);
+            m->nPos += n;
+            p = line;
+        }
+        memset(line + len, 0, line_len - len); /* djb-rwth: memset_s C11/Annex K variant? */
+    }
     else if (inp_stream->type == INCHI_IOS_TYPE_STRING)
     {
         /* Read from supplied string representing Molfile */
@@ -1048,273 +1132,6 @@ char* inchi_fgetsLf(char* line, int line_len, INCHI_IOSTREAM* inp_stream)
 }
 
 
-/****************************************************************************
-    Estimate printf string length.
-
-    The code is based on Microsoft Knowledge Base article Q127038:
-    "FIX: CString::Format Gives Assertion Failed, Access Violation"
-    (Related to Microsoft Visual C++, 32-bit Editions, versions 2.0, 2.1)
-****************************************************************************/
-
-#define FORCE_ANSI      0x10000
-#define FORCE_UNICODE   0x20000
-
-/****************************************************************************
- Formatting (using wsprintf style formatting)
-****************************************************************************/
-int GetMaxPrintfLength(const char* lpszFormat, va_list argList)
-{
-    /*ASSERT(AfxIsValidString(lpszFormat, FALSE));*/
-    const char* lpsz;
-    int nMaxLen, nWidth, nPrecision, nModifier, nItemLen;
-
-    nMaxLen = 0;
-    /* make a guess at the maximum length of the resulting string */
-    for (lpsz = lpszFormat; *lpsz; lpsz++)
-    {
-        /* moved from below for C syntax reason - 2024-09-01 DT */
-        /* djb-rwth: return values needed for va_arg; djb-rwth: ignoring LLVM warnings: function returning value */
-        int ivarg;
-        double dvarg;
-        void* ivvarg;
-        int* ipvarg;
-
-        /* handle '%' character, but watch out for '%%' */
-        if (*lpsz != '%' || *(++lpsz) == '%')
-        {
-            nMaxLen += 1;
-            continue;
-        }
-
-        nItemLen = 0;
-
-        /*  handle '%' character with format */
-        nWidth = 0;
-        for (; *lpsz; lpsz++)
-        {
-            /* check for valid flags */
-            if (*lpsz == '#')
-            {
-                nMaxLen += 2;   /* for '0x' */
-            }
-            else if (*lpsz == '*')
-            {
-                nWidth = va_arg(argList, int);
-            }
-            else if (*lpsz == '-' || *lpsz == '+' || *lpsz == '0'
-                || *lpsz == ' ')
-            {
-                ;
-            }
-            else /* hit non-flag character */
-            {
-                break;
-            }
-        }
-        /* get width and skip it */
-        if (nWidth == 0)
-        {
-            /* width indicated by */
-            nWidth = atoi(lpsz);
-            for (; *lpsz && isdigit(*lpsz); lpsz++)
-            {
-                ;
-            }
-        }
-        /*ASSERT(nWidth >= 0);*/
-        if (nWidth < 0)
-        {
-            goto exit_error; /* instead of exception */
-        }
-
-        nPrecision = 0;
-        if (*lpsz == '.')
-        {
-            /* skip past '.' separator (width.precision)*/
-            lpsz++;
-
-            /* get precision and skip it*/
-            if (*lpsz == '*')
-            {
-                nPrecision = va_arg(argList, int);
-                lpsz++;
-            }
-            else
-            {
-                nPrecision = atoi(lpsz);
-                for (; *lpsz && isdigit(*lpsz); lpsz++)
-                {
-                    ;
-                }
-            }
-            if (nPrecision < 0)
-            {
-                goto exit_error; /* instead of exception */
-            }
-        }
-
-        /* should be on type modifier or specifier */
-        nModifier = 0;
-        switch (*lpsz)
-        {
-            /* modifiers that affect size */
-        case 'h':
-            switch (lpsz[1])
-            {
-            case 'd':
-            case 'i':
-            case 'o':
-            case 'x':
-            case 'X':
-            case 'u':
-                /* short unsigned, short double, etc. -- added to the original MS example */
-                /* ignore the fact that these modifiers do affect size */
-                lpsz++;
-                break;
-            default:
-                nModifier = FORCE_ANSI;
-                lpsz++;
-                break;
-            }
-            break;
-        case 'l':
-            switch (lpsz[1])
-            {
-            case 'd':
-            case 'i':
-            case 'o':
-            case 'x':
-            case 'X':
-            case 'u':
-            case 'f': /* long float -- post ANSI C */
-                /* long unsigned, long double, etc. -- added to the original MS example */
-                /* ignore the fact that these modifiers do affect size */
-                lpsz++;
-                break;
-            default:
-                /*
-                nModifier = FORCE_UNICODE;
-                lpsz ++;
-                break;
-                */
-                goto exit_error;  /* no UNICODE, please */
-            }
-            break;
-            /* modifiers that do not affect size */
-        case 'F':
-        case 'N':
-        case 'L':
-            lpsz++;
-            break;
-        }
-
-        /* now should be on specifier */
-
-        switch (*lpsz | nModifier)
-        {
-            /* single characters*/
-        case 'c':
-        case 'C':
-            nItemLen = 2;
-            ivarg = va_arg(argList, int); /* djb-rwth: int return value; ignoring LLVM warning */
-            break;
-        case 'c' | FORCE_ANSI:
-        case 'C' | FORCE_ANSI:
-            nItemLen = 2;
-            ivarg = va_arg(argList, int); /* djb-rwth: int return value; ignoring LLVM warning */
-            break;
-        case 'c' | FORCE_UNICODE:
-        case 'C' | FORCE_UNICODE:
-            goto exit_error;  /* no UNICODE, please */
-            /*
-            nItemLen = 2;
-            va_arg(argList, wchar_t);
-            break;
-            */
-
-            /* strings*/
-        case 's':
-        case 'S':
-            nItemLen = (int)strlen(va_arg(argList, char*));
-            nItemLen = inchi_max(1, nItemLen);
-            break;
-        case 's' | FORCE_ANSI:
-        case 'S' | FORCE_ANSI:
-            nItemLen = (int)strlen(va_arg(argList, char*));
-            nItemLen = inchi_max(1, nItemLen);
-            break;
-
-        case 's' | FORCE_UNICODE:
-        case 'S' | FORCE_UNICODE:
-            goto exit_error;  /* no UNICODE, please */
-            /*
-            nItemLen = wcslen(va_arg(argList, wchar_t*));
-            nItemLen = inchi_max(1, nItemLen);
-            break;
-            */
-        }
-
-        /* adjust nItemLen for strings */
-        if (nItemLen != 0)
-        {
-            nItemLen = inchi_max(nItemLen, nWidth);
-            if (nPrecision != 0)
-            {
-                nItemLen = inchi_min(nItemLen, nPrecision);
-            }
-        }
-        else
-        {
-            switch (*lpsz)
-            {
-                /* integers */
-            case 'd':
-            case 'i':
-            case 'u':
-            case 'x':
-            case 'X':
-            case 'o':
-                ivarg = va_arg(argList, int); /* djb-rwth: int return value; ignoring LLVM warning */
-                nItemLen = 32;
-                nItemLen = inchi_max(nItemLen, nWidth + nPrecision);
-                break;
-
-            case 'e':
-            case 'f':
-            case 'g':
-            case 'G':
-                dvarg = va_arg(argList, double); /* djb-rwth: double return value; ignoring LLVM warning */
-                nItemLen = 32;
-                nItemLen = inchi_max(nItemLen, nWidth + nPrecision);
-                break;
-
-            case 'p':
-                ivvarg = va_arg(argList, void*); /* djb-rwth: void* return value; ignoring LLVM warning */
-                nItemLen = 32;
-                nItemLen = inchi_max(nItemLen, nWidth + nPrecision);
-                break;
-
-                /* no output */
-            case 'n':
-                ipvarg = va_arg(argList, int*); /* djb-rwth: int* return value; ignoring LLVM warning */
-                break;
-
-            default:
-                /*ASSERT(FALSE);*/  /* unknown formatting option*/
-                goto exit_error; /* instead of exception */
-            }
-        }
-
-        /* adjust nMaxLen for output nItemLen */
-        nMaxLen += nItemLen;
-    }
-    return nMaxLen;
-
-exit_error:
-    return -1; /* wrong format */
-}
-
-
 /****************************************************************************
     Get at most n-1 chars, plus a null, then advance input's start.
     Return emulates fgets()
@@ -1506,7 +1323,7 @@ int inchi_strbuf_update(INCHI_IOS_STRING* buf, int new_addition_size)
 ****************************************************************************/
 int inchi_strbuf_printf(INCHI_IOS_STRING* buf, const char* lpszFormat, ...)
 {
-    int ret = 0, max_len;
+    int ret;
     va_list argList;
 
     if (!buf)
@@ -1515,22 +1332,8 @@ int inchi_strbuf_printf(INCHI_IOS_STRING* buf, const char* lpszFormat, ...)
     }
 
     my_va_start(argList, lpszFormat);
-    max_len = GetMaxPrintfLength(lpszFormat, argList);
-    va_end(argList);
-    if (max_len < 0)
-    {
-        return 0;
-    }
-
-    inchi_strbuf_update(buf, max_len);
-
-    my_va_start(argList, lpszFormat);
-    ret = vsprintf(buf->pStr + buf->nUsedLength, lpszFormat, argList);
+    ret = inchi_strbuf_vprintf(buf, lpszFormat, argList);
     va_end(argList);
-    if (ret >= 0)
-    {
-        buf->nUsedLength += ret;
-    }
 
     return ret;
 }
@@ -1545,7 +1348,7 @@ int inchi_strbuf_printf_from(INCHI_IOS_STRING* buf,
     int npos,
     const char* lpszFormat, ...)
 {
-    int ret = 0, max_len;
+    int ret;
     va_list argList;
 
     if (!buf)
@@ -1553,105 +1356,257 @@ int inchi_strbuf_printf_from(INCHI_IOS_STRING* buf,
         return -1;
     }
 
+    buf->nUsedLength = npos;
     my_va_start(argList, lpszFormat);
-    max_len = GetMaxPrintfLength(lpszFormat, argList);
+    ret = inchi_strbuf_vprintf(buf, lpszFormat, argList);
     va_end(argList);
-    if (max_len < 0)
+
+    return ret;
+}
+
+
+/****************************************************************************
+    Make room for at least n more chars and the terminating zero in str buf.
+    The buffer grows at least twofold (so that appending stays linear in
+    the total length) and is not zero-filled.
+    Returns the new allocated length or -1 on error.
+****************************************************************************/
+static int inchi_strbuf_reserve(INCHI_IOS_STRING* buf, int n)
+{
+    long long need = (long long)buf->nUsedLength + (long long)n + 1;
+    long long new_len;
+    char* new_str;
+
+    if (buf->pStr && need <= buf->nAllocatedLength)
     {
-        return 0;
+        return buf->nAllocatedLength;
+    }
+    if (need > INT_MAX)
+    {
+        return -1;
     }
+    new_len = inchi_max(need, 2LL * buf->nAllocatedLength);
+    new_len = inchi_max(new_len, INCHI_ADD_STR_LEN);
+    new_len = inchi_min(new_len, INT_MAX);
+
+    new_str = (char*)inchi_realloc(buf->pStr, (size_t)new_len);
+    if (!new_str)
+    {
+        return -1;
+    }
+    buf->pStr = new_str;
+    buf->nAllocatedLength = (int)new_len;
 
-    max_len += npos;
+    return buf->nAllocatedLength;
+}
 
-    inchi_strbuf_update(buf, max_len);
 
-    my_va_start(argList, lpszFormat);
-    ret = vsprintf(buf->pStr + npos, lpszFormat, argList);
-    va_end(argList);
-    if (ret >= 0)
+/****************************************************************************
+    stb_sprintf callback: 'len' chars have been formatted in place at the
+    end of the string; make room for the next chunk
+****************************************************************************/
+static char* inchi_strbuf_vprintf_cb(const char* chunk, void* user, int len)
+{
+    INCHI_IOS_STRING* buf = (INCHI_IOS_STRING*)user;
+
+    (void)chunk; /* == buf->pStr + buf->nUsedLength before the update */
+    buf->nUsedLength += len;
+    if (0 > inchi_strbuf_reserve(buf, STB_SPRINTF_MIN))
     {
-        buf->nUsedLength = npos + ret;
+        buf->nUsedLength -= len;
+        return NULL;
     }
 
-    return ret;
+    return buf->pStr + buf->nUsedLength;
 }
 
 
 /****************************************************************************
-    Reads the next line to growing str buf.
-    Returns n of read chars, -1 at end of file or at error.
-*****************************************************************************/
-int inchi_strbuf_getline(INCHI_IOS_STRING* buf,
-    FILE* f,
-    int crlf2lf,
-    int preserve_lf)
+    Check if the format has a floating point conversion (e, f, g, a)
+****************************************************************************/
+static int inchi_strbuf_has_float_format(const char* lpszFormat)
 {
-    int c;
-    inchi_strbuf_reset(buf);
+    const char* p = lpszFormat;
 
-    while (1)
+    while ((p = strchr(p, '%')))
     {
-        c = fgetc(f);
-        if (ferror(f))
+        p++;
+        p += strspn(p, "-+ #'0123456789.*hlLqjzt");
+        if (!*p)
         {
-            return -1;
-        }
-        if (c == EOF)
-        {
-            return -1;
+            break;
         }
-        inchi_strbuf_printf(buf, "%c", c);
-        if (c == '\n')
+        if (strchr("eEfFgGaA", *p))
         {
-            break;
+            return 1;
         }
+        p++; /* conversion char or the second '%' of "%%" */
     }
 
-    if (crlf2lf)
+    return 0;
+}
+
+
+/****************************************************************************
+    Append formatted output to str buf in a single pass: stb_sprintf
+    formats directly into the tail of the buffer, which is expanded
+    whenever less than STB_SPRINTF_MIN chars are left.
+    stb_sprintf rounds floating point numbers differently from the C
+    runtime, so formats with e, f, g or a conversions go to vsnprintf()
+    into the tail of the buffer instead, once more if it was too short.
+    Returns n of added chars or -1 on error (buf is left unchanged).
+****************************************************************************/
+static int inchi_strbuf_vprintf(INCHI_IOS_STRING* buf,
+    const char* lpszFormat,
+    va_list argList)
+{
+    int nUsedLength0 = buf->nUsedLength, ret;
+
+    if (0 > inchi_strbuf_reserve(buf, STB_SPRINTF_MIN))
     {
-        if (buf->nUsedLength > 2)
+        return -1;
+    }
+    if (inchi_strbuf_has_float_format(lpszFormat))
+    {
+        int room = buf->nAllocatedLength - buf->nUsedLength;
+        va_list argCopy;
+
+        va_copy(argCopy, argList);
+        ret = vsnprintf(buf->pStr + buf->nUsedLength, room, lpszFormat, argCopy);
+        va_end(argCopy);
+        if (ret >= room)
         {
-            if (buf->pStr[buf->nUsedLength - 2] == '\r')
-            {
-                buf->pStr[buf->nUsedLength - 2] = '\n';
-                buf->pStr[--buf->nUsedLength] = '\0';
-            }
+            ret = (0 > inchi_strbuf_reserve(buf, ret)) ? -1
+                : vsnprintf(buf->pStr + buf->nUsedLength, (size_t)ret + 1, lpszFormat, argList);
         }
+        if (ret < 0)
+        {
+            buf->pStr[buf->nUsedLength] = '\0';
+            return -1;
+        }
+        buf->nUsedLength += ret;
+
+        return ret;
     }
-    if (!preserve_lf)
+    ret = stbsp_vsprintfcb(inchi_strbuf_vprintf_cb, buf,
+        buf->pStr + buf->nUsedLength, lpszFormat, argList);
+    if (ret < 0 || buf->nUsedLength - nUsedLength0 != ret)
     {
-        buf->pStr[--buf->nUsedLength] = '\0';
+        buf->nUsedLength = nUsedLength0;
+        buf->pStr[buf->nUsedLength] = '\0';
+        return -1;
     }
+    buf->pStr[buf->nUsedLength] = '\0';
 
-    return buf->nUsedLength;
+    return ret;
 }
 
 
-
 /****************************************************************************
-    Adds the next line to growing str buf (does not reset buf before adding).
-    Returns n of read chars, -1 at end of file or at error.
+    Append to str buf the input up to and including the next '\n'.
+    In-memory (string or mapped) input is scanned with memchr and copied
+    as one block; a plain file is read with fgets directly into the tail
+    of the buffer, so that no char goes through the printf machinery.
+    Returns 1 if '\n' has been read, 0 at end of input, -1 at error.
 ****************************************************************************/
-int inchi_strbuf_addline(INCHI_IOS_STRING* buf,
+static int inchi_strbuf_append_line(INCHI_IOS_STRING* buf,
     INCHI_IOSTREAM* inp_stream,
-    int crlf2lf,
-    int preserve_lf)
+    FILE* f)
 {
-    int c;
+    if (inp_stream && inp_stream->type == INCHI_IOS_TYPE_FILE)
+    {
+        f = inp_stream->f;
+    }
+    else if (inp_stream)
+    {
+        const char* pData, * pLf;
+        size_t      nLen, nPos, n;
+
+        if (inp_stream->type == INCHI_IOS_TYPE_STRING)
+        {
+            pData = inp_stream->s.pStr;
+            nLen = inp_stream->s.nUsedLength > 0 ? (size_t)inp_stream->s.nUsedLength : 0;
+            nPos = inp_stream->s.nPtr > 0 ? (size_t)inp_stream->s.nPtr : 0;
+        }
+        else if (inp_stream->type == INCHI_IOS_TYPE_MMAP && inp_stream->m)
+        {
+            pData = inp_stream->m->pData;
+            nLen = inp_stream->m->nLen;
+            nPos = inp_stream->m->nPos;
+        }
+        else
+        {
+            return -1;
+        }
+        if (nPos >= nLen)
+        {
+            return 0;
+        }
+        pLf = (const char*)memchr(pData + nPos, '\n', nLen - nPos);
+        n = pLf ? (size_t)(pLf - pData) + 1 - nPos : nLen - nPos;
+        if (n >= (size_t)(INT_MAX - buf->nUsedLength) ||
+            0 > inchi_strbuf_reserve(buf, (int)n))
+        {
+            return -1;
+        }
+        memcpy(buf->pStr + buf->nUsedLength, pData + nPos, n);
+        buf->nUsedLength += (int)n;
+        buf->pStr[buf->nUsedLength] = '\0';
+        if (inp_stream->type == INCHI_IOS_TYPE_STRING)
+        {
+            inp_stream->s.nPtr = (int)(nPos + n);
+        }
+        else
+        {
+            inp_stream->m->nPos = nPos + n;
+        }
+        return pLf ? 1 : 0;
+    }
 
+    if (!f)
+    {
+        return -1;
+    }
     while (1)
     {
-        c = inchi_ios_str_getc(inp_stream);
-        if (c == EOF)
+        char* p;
+        int   nFree, n;
+
+        if (0 > inchi_strbuf_reserve(buf, INCHI_STRBUF_LINE_CHUNK))
         {
             return -1;
         }
-        inchi_strbuf_printf(buf, "%c", c);
-        if (c == '\n')
+        p = buf->pStr + buf->nUsedLength;
+        nFree = buf->nAllocatedLength - buf->nUsedLength;
+        if (!fgets(p, nFree, f))
         {
-            break;
+            *p = '\0';
+            return ferror(f) ? -1 : 0;
+        }
+        n = (int)strlen(p);
+        buf->nUsedLength += n;
+        if (n > 0 && p[n - 1] == '\n')
+        {
+            return 1;
+        }
+        if (n < nFree - 1 && !feof(f))
+        {
+            /* embedded '\0': fgets has already consumed the rest of the line */
+            buf->pStr[buf->nUsedLength++] = '\n';
+            buf->pStr[buf->nUsedLength] = '\0';
+            return 1;
         }
     }
+}
+
+
+/****************************************************************************
+    Convert the line ending of the line just read into str buf
+****************************************************************************/
+static int inchi_strbuf_end_line(INCHI_IOS_STRING* buf,
+    int crlf2lf,
+    int preserve_lf)
+{
     if (crlf2lf)
     {
         if (buf->nUsedLength > 2)
@@ -1672,13 +1627,53 @@ int inchi_strbuf_addline(INCHI_IOS_STRING* buf,
 }
 
 
+/****************************************************************************
+    Reads the next line to growing str buf.
+    Returns n of read chars, -1 at end of file or at error.
+****************************************************************************/
+int inchi_strbuf_getline(INCHI_IOS_STRING* buf,
+    FILE* f,
+    int crlf2lf,
+    int preserve_lf)
+{
+    inchi_strbuf_reset(buf);
+
+    if (1 != inchi_strbuf_append_line(buf, NULL, f))
+    {
+        return -1;
+    }
+
+    return inchi_strbuf_end_line(buf, crlf2lf, preserve_lf);
+}
+
+
+
+/****************************************************************************
+    Adds the next line to growing str buf (does not reset buf before adding).
+    Returns n of read chars, -1 at end of file or at error.
+****************************************************************************/
+int inchi_strbuf_addline(INCHI_IOS_STRING* buf,
+    INCHI_IOSTREAM* inp_stream,
+    int crlf2lf,
+    int preserve_lf)
+{
+    if (1 != inchi_strbuf_append_line(buf, inp_stream, NULL))
+    {
+        return -1;
+    }
+
+    return inchi_strbuf_end_line(buf, crlf2lf, preserve_lf);
+}
+
+
 #if ( defined(_WIN32) && defined(_DEBUG) && defined(_MSC_VER) )
 #include <windows.h>
 
 
 /****************************************************************************/
-/* djb-rwth: placed as a global variable to avoid function buffer issues */
-char it_buffer[32767];
+/* djb-rwth: buffer is not placed on the stack to avoid function buffer issues */
+/* v. 1.07+: allocated per call rather than a global to keep the function reentrant */
+#define IT_BUFFER_LEN 32767
 int _inchi_trace(char* format, ...)
 {
     /*
@@ -1686,15 +1681,23 @@ int _inchi_trace(char* format, ...)
     char buffer[32767];
     */
     int ret;
+    char *it_buffer = (char *) inchi_malloc( IT_BUFFER_LEN );
 
     va_list argptr;
+    if (!it_buffer)
+    {
+        return 0;
+    }
     va_start(argptr, format);
     /*wvsprintf(buffer, format, argptr);*/
-    ret = vsprintf(it_buffer, format, argptr);
+    ret = vsnprintf(it_buffer, IT_BUFFER_LEN, format, argptr);
     va_end(argptr);
+    it_buffer[IT_BUFFER_LEN - 1] = '\0';
     OutputDebugString(it_buffer);
+    inchi_free( it_buffer );
     return 1;
 }
+#undef IT_BUFFER_LEN
 #else
 int _inchi_trace(char* format, ...)
 {
@@ -49,6 +49,18 @@
 
 
 #include "mode.h"
+
+/* v. 1.07+: 64-bit positions of input files, also on Win64 where long has 32 bits */
+#if defined(_WIN32)
+#define inchi_fseek64( f, pos )     _fseeki64( f, pos, SEEK_SET )
+#define inchi_fseek64_end( f )      _fseeki64( f, 0, SEEK_END )
+#define inchi_ftell64( f )          _ftelli64( f )
+#else
+#define inchi_fseek64( f, pos )     fseeko( f, (off_t) ( pos ), SEEK_SET )
+#define inchi_fseek64_end( f )      fseeko( f, 0, SEEK_END )
+#define inchi_ftell64( f )          ( (long long) ftello( f ) )
+#endif
+
 #ifndef COMPILE_ALL_CPP
 #ifdef __cplusplus
 extern "C" {
@@ -63,10 +75,14 @@ extern "C" {
     void inchi_ios_reset( INCHI_IOSTREAM *ios );
     void inchi_ios_free_str( INCHI_IOSTREAM *ios );
     int inchi_ios_create_copy( INCHI_IOSTREAM* ios, INCHI_IOSTREAM* ios0 );
+    int inchi_ios_mmap( INCHI_IOSTREAM *ios );
+    long long inchi_ios_tell( INCHI_IOSTREAM *ios );
+    int inchi_ios_seek( INCHI_IOSTREAM *ios, long long pos );
 
     int inchi_ios_gets( char *szLine, int len, INCHI_IOSTREAM *ios, int *bTooLongLine );
     int inchi_ios_getsTab( char *szLine, int len, INCHI_IOSTREAM *ios, int *bTooLongLine );
     int inchi_ios_getsTab1( char *szLine, int len, INCHI_IOSTREAM *ios, int *bTooLongLine );
+    int inchi_ios_str_getc( INCHI_IOSTREAM *ios );
 
     int inchi_ios_print( INCHI_IOSTREAM *ios, const char* lpszFormat, ... );
     int inchi_ios_print_nodisplay( INCHI_IOSTREAM *ios, const char* lpszFormat, ... );
@@ -101,6 +117,7 @@ extern "C" {
 #define INCHI_STRBUF_SIZE_INCREMENT 262144
 #define INCHI_STRBUF_SMALLER_INITIAL_SIZE 1024
 #define INCHI_STRBUF_SMALLER_SIZE_INCREMENT 4096
+#define INCHI_STRBUF_LINE_CHUNK 4096 /* v. 1.07+ min. free space when reading a line from file */
 
 int inchi_strbuf_init( INCHI_IOS_STRING *buf, int start_size, int incr_size );
 void inchi_strbuf_reset( INCHI_IOS_STRING *buf );
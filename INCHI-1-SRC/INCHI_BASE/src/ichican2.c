@@ -45,6 +45,9 @@
 #include <string.h>
 #include <limits.h>
 #include <time.h>
+#if ( defined(_MSC_VER) && defined(_WIN64) )
+#include <intrin.h> /* _BitScanForward64 */
+#endif
 
 
 #include "mode.h"
@@ -59,6 +62,14 @@
 #define MAX_NODES    32766
 #define MAX_SET_SIZE 32766 /*16384*/
 #define NORMALLY_ALLOWED_MAX_SET_SIZE 2048
+
+/* v. 1.07+: CANON_ARENA alignment and the largest pBuf kept between calls */
+#define CANON_ARENA_ALIGN     16
+#define CANON_ARENA_MAX_SIZE  ((size_t) 64 * 1024 * 1024)
+
+/* v. 1.07+: below this number of atoms inchi_qsort() is faster than SortAtomInvariants2() */
+#define RADIX_SORT_MIN_ATOMS  16
+
 #define MAX_LAYERS   100
 
 #define SEPARATE_CANON_CALLS 0
@@ -76,11 +87,16 @@
 /*
 #define INCHI_CANON_USE_HASH
 */ /* djb-rwth: constant has not been defined? */
+/* v. 1.07+: keep INCHI_CANON_USE_HASH undefined. Equal hashes of two CT levels
+   do not prove that the levels are equal, and unequal hashes still need the
+   exact Ctbl scan for the sign and the position of the first difference,
+   so CtPartCompare() cannot skip comparing any element safely. */
 #ifdef INCHI_CANON_USE_HASH
 typedef unsigned long  U_INT_32;
 typedef unsigned char  U_INT_08;
 typedef U_INT_32       CtHash;
-CtHash hash_mark_bit;
+/* highest bit in CtHash; v. 1.07+: constant rather than a global set in the former SetBitCreate() */
+#define hash_mark_bit  ((CtHash)( ~((CtHash)~0 >> 1) ))
 #endif
 
 /* -- moved to ichi_bns.h --
@@ -91,8 +107,10 @@ typedef U_SHORT  bitWord;
 /*bitWord      mark_bit; */    /* highest bit in AT_NUMB */
 /*bitWord      mask_bit; */    /* ~mark_bit */
 
-static AT_NUMB       rank_mark_bit;
-static AT_NUMB       rank_mask_bit;
+/* v. 1.07+: constants rather than file-scope variables set in the former SetBitCreate() */
+/* so that concurrent canonicalizations do not share mutable state */
+#define rank_mark_bit  ((AT_NUMB)( AT_RANK_MASK ^ ( AT_RANK_MASK >> 1 ) )) /* highest bit in AT_NUMB */
+#define rank_mask_bit  ((AT_NUMB)( AT_RANK_MASK >> 1 ))                    /* ~rank_mark_bit */
 
 
 typedef AT_NUMB    Node;
@@ -297,23 +315,23 @@ int  PartitionGetFirstCell( Partition *p, Cell *baseW, int k, int n );
 
 int  PartitionIsDiscrete( Partition *p, int n );
 
-void PartitionFree( Partition *p );
+void PartitionFree( struct tagCANON_GLOBALS *pCG, Partition *p );
 
-int  PartitionCreate( Partition *p, int n );
+int  PartitionCreate( struct tagCANON_GLOBALS *pCG, Partition *p, int n );
 
 void UnorderedPartitionMakeDiscrete( UnorderedPartition *p, int n );
 
-void UnorderedPartitionFree( UnorderedPartition *p );
+void UnorderedPartitionFree( struct tagCANON_GLOBALS *pCG, UnorderedPartition *p );
 
-int  UnorderedPartitionCreate( UnorderedPartition *p, int n );
+int  UnorderedPartitionCreate( struct tagCANON_GLOBALS *pCG, UnorderedPartition *p, int n );
 
-void CTableFree( ConTable *Ct );
+void CTableFree( struct tagCANON_GLOBALS *pCG, ConTable *Ct );
 
-int  CTableCreate( ConTable *Ct, int n, CANON_DATA *pCD );
+int  CTableCreate( struct tagCANON_GLOBALS *pCG, ConTable *Ct, int n, CANON_DATA *pCD );
 
-void TranspositionFree( Transposition *p );
+void TranspositionFree( struct tagCANON_GLOBALS *pCG, Transposition *p );
 
-int  TranspositionCreate( Transposition *p, int n );
+int  TranspositionCreate( struct tagCANON_GLOBALS *pCG, Transposition *p, int n );
 
 void TranspositionGetMcrAndFixSetAndUnorderedPartition( struct tagCANON_GLOBALS *pCG, Transposition *gamma, NodeSet *McrSet, NodeSet *FixSet, int n, int l, UnorderedPartition *p );
 
@@ -649,41 +667,26 @@ int CanonGraph12( int n,
 #ifdef INCHI_CANON_USE_HASH
 
 
-static call_fill_crc32_data = 1;
-static const U_INT_32 crc32_data[256];
-
-
 /****************************************************************************/
-void fill_crc32_data( )
+/* v. 1.07+: no lazily filled static table, so that add2crc32() is reentrant */
+static U_INT_32 crc32_add_byte( U_INT_32 crc32, U_INT_08 chr )
 {
-    U_INT_32 c;
-    int n, k;
+    int k;
 
-    for (n = 0; n < 256; n++)
+    crc32 ^= chr;
+    for (k = 0; k < 8; k++)
     {
-        c = (U_INT_32) n;
-        for (k = 0; k < 8; k++)
-        {
-            c = c & 1 ? 0xEDB88320L ^ ( c >> 1 ) : c >> 1;
-        }
-        crc32_data[n] = c;
+        crc32 = crc32 & 1 ? 0xEDB88320L ^ ( crc32 >> 1 ) : crc32 >> 1;
     }
-    call_fill_crc32_data = 0;
+    return crc32;
 }
 
 
 /****************************************************************************/
 unsigned long add2crc32( unsigned long crc32, AT_NUMB n )
 {
-    U_INT_08 chr;
-    if (call_fill_crc32_data)
-    {
-        fill_crc32_data( );
-    }
-    chr = n % 128;
-    crc32 = crc32_data[( (int) crc32 ^ (int) chr ) & 0xff] ^ ( crc32 >> 8 );
-    chr = n / 128;
-    crc32 = crc32_data[( (int) crc32 ^ (int) chr ) & 0xff] ^ ( crc32 >> 8 );
+    crc32 = crc32_add_byte( (U_INT_32) crc32, (U_INT_08) ( n % 128 ) );
+    crc32 = crc32_add_byte( (U_INT_32) crc32, (U_INT_08) ( n / 128 ) );
     return crc32;
 }
 #endif
@@ -691,9 +694,9 @@ unsigned long add2crc32( unsigned long crc32, AT_NUMB n )
 
 
 /****************************************************************************/
-int TranspositionCreate( Transposition *p, int n )
+int TranspositionCreate( CANON_GLOBALS *pCG, Transposition *p, int n )
 {
-    p->nAtNumb = (AT_NUMB*) inchi_calloc( n, sizeof( p->nAtNumb[0] ) );
+    p->nAtNumb = (AT_NUMB*) CanonArenaAlloc( pCG, n, sizeof( p->nAtNumb[0] ), 1 );
     if (p->nAtNumb)
     {
         return 1;
@@ -704,16 +707,44 @@ int TranspositionCreate( Transposition *p, int n )
 
 
 /****************************************************************************/
-void TranspositionFree( Transposition *p )
+void TranspositionFree( CANON_GLOBALS *pCG, Transposition *p )
 {
     if (p && p->nAtNumb)
     {
-        inchi_free( p->nAtNumb );
+        CanonArenaRelease( pCG, p->nAtNumb );
         p->nAtNumb = NULL;
     }
 }
 
 
+#ifdef BIT_WORD_PORTABLE_CTZ
+/****************************************************************************
+  Number of trailing zero bits in a non-zero set word
+****************************************************************************/
+int BitWordCtz( bitWord w )
+{
+#if ( defined(_MSC_VER) && defined(_WIN64) )
+    unsigned long idx;
+    _BitScanForward64( &idx, w );
+    return (int) idx;
+#else
+    int n = 0;
+    while (!( w & 0xFFFF ))
+    {
+        w >>= 16;
+        n += 16;
+    }
+    while (!( w & 1 ))
+    {
+        w >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+#endif
+
+
 /****************************************************************************/
 int NodeSetCreate( struct tagCANON_GLOBALS *pCG,
                    NodeSet *pSet,
@@ -722,19 +753,19 @@ int NodeSetCreate( struct tagCANON_GLOBALS *pCG,
 {
     int i, len;
 
-    len = ( n + pCG->m_num_bit - 1 ) / pCG->m_num_bit;
+    len = ( n + BIT_WORD_BITS - 1 ) / BIT_WORD_BITS;
 
-    pSet->bitword = (bitWord**) inchi_calloc( L, sizeof( pSet->bitword[0] ) );
+    pSet->bitword = (bitWord**) CanonArenaAlloc( pCG, L, sizeof( pSet->bitword[0] ), 0 );
 
     if (!pSet->bitword)
     {
         return 0;
     }
-    pSet->bitword[0] = (bitWord*) inchi_calloc( (long long)len * (long long)L, sizeof( pSet->bitword[0][0] ) ); /* djb-rwth: cast operators added */
+    pSet->bitword[0] = (bitWord*) CanonArenaAlloc( pCG, (size_t) len * (size_t) L, sizeof( pSet->bitword[0][0] ), 1 ); /* djb-rwth: cast operators added */
     if (!pSet->bitword[0])
     {
         /* Cleanup */
-        inchi_free( pSet->bitword );
+        CanonArenaRelease( pCG, pSet->bitword );
         pSet->bitword = NULL;
         return 0; /* failed */
     }
@@ -757,16 +788,16 @@ void NodeSetFree( struct tagCANON_GLOBALS *pCG, NodeSet *pSet )
     {
         if (pSet->bitword[0])
         {
-            inchi_free( pSet->bitword[0] );
+            CanonArenaRelease( pCG, pSet->bitword[0] );
         }
-        inchi_free( pSet->bitword );
+        CanonArenaRelease( pCG, pSet->bitword );
         pSet->bitword = NULL;
     }
 }
 
 
 /****************************************************************************/
-int CTableCreate( ConTable *Ct, int n, CANON_DATA *pCD )
+int CTableCreate( CANON_GLOBALS *pCG, ConTable *Ct, int n, CANON_DATA *pCD )
 {
     int maxlenCt = pCD->nMaxLenLinearCT + 1; /* add one element for CtPartINCHI_CANON_INFINITY() */
     int maxlenNumH = pCD->NumH ? ( pCD->maxlenNumH + 1 ) : 0;
@@ -784,33 +815,33 @@ int CTableCreate( ConTable *Ct, int n, CANON_DATA *pCD )
 
     n++;
 
-    Ct->Ctbl = (AT_RANK*) inchi_calloc( maxlenCt, sizeof( Ct->Ctbl[0] ) );
-    Ct->nextCtblPos = (AT_NUMB*) inchi_calloc( n, sizeof( Ct->nextCtblPos[0] ) );
-    Ct->nextAtRank = (AT_RANK*) inchi_calloc( n, sizeof( Ct->nextAtRank[0] ) );
+    Ct->Ctbl = (AT_RANK*) CanonArenaAlloc( pCG, maxlenCt, sizeof( Ct->Ctbl[0] ), 1 );
+    Ct->nextCtblPos = (AT_NUMB*) CanonArenaAlloc( pCG, n, sizeof( Ct->nextCtblPos[0] ), 1 );
+    Ct->nextAtRank = (AT_RANK*) CanonArenaAlloc( pCG, n, sizeof( Ct->nextAtRank[0] ), 1 );
     if (maxlenNumH)
     {
-        Ct->NumH = (NUM_H *) inchi_calloc( maxlenNumH, sizeof( Ct->NumH[0] ) );
+        Ct->NumH = (NUM_H *) CanonArenaAlloc( pCG, maxlenNumH, sizeof( Ct->NumH[0] ), 1 );
     }
     if (maxlenNumHfixed)
     {
-        Ct->NumHfixed = (NUM_H *) inchi_calloc( maxlenNumHfixed, sizeof( Ct->NumH[0] ) );
+        Ct->NumHfixed = (NUM_H *) CanonArenaAlloc( pCG, maxlenNumHfixed, sizeof( Ct->NumH[0] ), 1 );
     }
     if (maxlenIso)
     {
-        Ct->iso_sort_key = (AT_ISO_SORT_KEY *) inchi_calloc( maxlenIso, sizeof( Ct->iso_sort_key[0] ) );
+        Ct->iso_sort_key = (AT_ISO_SORT_KEY *) CanonArenaAlloc( pCG, maxlenIso, sizeof( Ct->iso_sort_key[0] ), 1 );
     }
     if (maxlenIsoExchg)
     {
-        Ct->iso_exchg_atnos = (S_CHAR *) inchi_calloc( maxlenIsoExchg, sizeof( Ct->iso_exchg_atnos[0] ) );
+        Ct->iso_exchg_atnos = (S_CHAR *) CanonArenaAlloc( pCG, maxlenIsoExchg, sizeof( Ct->iso_exchg_atnos[0] ), 1 );
     }
 #if ( USE_ISO_SORT_KEY_HFIXED == 1 )
     if (maxlenIsoHfixed)
     {
-        Ct->iso_sort_key_Hfixed = (AT_ISO_SORT_KEY *) inchi_calloc( maxlenIsoHfixed, sizeof( Ct->iso_sort_key_Hfixed[0] ) );
+        Ct->iso_sort_key_Hfixed = (AT_ISO_SORT_KEY *) CanonArenaAlloc( pCG, maxlenIsoHfixed, sizeof( Ct->iso_sort_key_Hfixed[0] ), 1 );
     }
 #endif
 #ifdef INCHI_CANON_USE_HASH
-    Ct->hash = (CtHash*) inchi_calloc( n, sizeof( Ct->hash[0] ) );
+    Ct->hash = (CtHash*) CanonArenaAlloc( pCG, n, sizeof( Ct->hash[0] ), 1 );
 #endif
 
     Ct->lenCt = 0;
@@ -848,50 +879,50 @@ int CTableCreate( ConTable *Ct, int n, CANON_DATA *pCD )
 
 
 /****************************************************************************/
-void CTableFree( ConTable *Ct )
+void CTableFree( CANON_GLOBALS *pCG, ConTable *Ct )
 {
     if (Ct)
     {
         if (Ct->Ctbl)
         {
-            inchi_free( Ct->Ctbl );
+            CanonArenaRelease( pCG, Ct->Ctbl );
         }
         if (Ct->nextCtblPos)
         {
-            inchi_free( Ct->nextCtblPos );
+            CanonArenaRelease( pCG, Ct->nextCtblPos );
         }
         if (Ct->nextAtRank)
         {
-            inchi_free( Ct->nextAtRank );
+            CanonArenaRelease( pCG, Ct->nextAtRank );
         }
         if (Ct->NumH)
         {
-            inchi_free( Ct->NumH );
+            CanonArenaRelease( pCG, Ct->NumH );
         }
         if (Ct->NumHfixed)
         {
-            inchi_free( Ct->NumHfixed );
+            CanonArenaRelease( pCG, Ct->NumHfixed );
         }
         if (Ct->iso_sort_key)
         {
-            inchi_free( Ct->iso_sort_key );
+            CanonArenaRelease( pCG, Ct->iso_sort_key );
         }
         if (Ct->iso_exchg_atnos)
         {
-            inchi_free( Ct->iso_exchg_atnos );
+            CanonArenaRelease( pCG, Ct->iso_exchg_atnos );
         }
 
 #if ( USE_ISO_SORT_KEY_HFIXED == 1 )
         if (Ct->iso_sort_key_Hfixed)
         {
-            inchi_free( Ct->iso_sort_key_Hfixed );
+            CanonArenaRelease( pCG, Ct->iso_sort_key_Hfixed );
         }
 #endif
 
 #ifdef INCHI_CANON_USE_HASH
         if (Ct->hash)
         {
-            inchi_free( Ct->hash );
+            CanonArenaRelease( pCG, Ct->hash );
         }
 #endif
 
@@ -901,9 +932,9 @@ void CTableFree( ConTable *Ct )
 
 
 /****************************************************************************/
-int UnorderedPartitionCreate( UnorderedPartition *p, int n )
+int UnorderedPartitionCreate( CANON_GLOBALS *pCG, UnorderedPartition *p, int n )
 {
-    p->equ2 = (AT_NUMB*) inchi_calloc( n, sizeof( p->equ2[0] ) );
+    p->equ2 = (AT_NUMB*) CanonArenaAlloc( pCG, n, sizeof( p->equ2[0] ), 1 );
     /* p->next = (AT_NUMB*)inchi_calloc( n, sizeof(p->next[0])); */
 
     if (p->equ2 /*&& p->next*/)
@@ -916,11 +947,11 @@ int UnorderedPartitionCreate( UnorderedPartition *p, int n )
 
 
 /****************************************************************************/
-void UnorderedPartitionFree( UnorderedPartition *p )
+void UnorderedPartitionFree( CANON_GLOBALS *pCG, UnorderedPartition *p )
 {
     if (p->equ2)
     {
-        inchi_free( p->equ2 );
+        CanonArenaRelease( pCG, p->equ2 );
     }
 
     /* if (p->next) inchi_free( p->next); */
@@ -943,10 +974,10 @@ void UnorderedPartitionMakeDiscrete( UnorderedPartition *p, int n )
 
 
 /****************************************************************************/
-int PartitionCreate( Partition *p, int n )
+int PartitionCreate( CANON_GLOBALS *pCG, Partition *p, int n )
 {
-    p->AtNumber = (AT_NUMB*) inchi_calloc( n, sizeof( p->AtNumber[0] ) );
-    p->Rank = (AT_RANK*) inchi_calloc( n, sizeof( p->Rank[0] ) );
+    p->AtNumber = (AT_NUMB*) CanonArenaAlloc( pCG, n, sizeof( p->AtNumber[0] ), 1 );
+    p->Rank = (AT_RANK*) CanonArenaAlloc( pCG, n, sizeof( p->Rank[0] ), 1 );
     if (p->AtNumber && p->Rank)
     {
         return 1;
@@ -956,18 +987,18 @@ int PartitionCreate( Partition *p, int n )
 
 
 /****************************************************************************/
-void PartitionFree( Partition *p )
+void PartitionFree( CANON_GLOBALS *pCG, Partition *p )
 {
     if (p)
     {
         if (p->AtNumber)
         {
-            inchi_free( p->AtNumber );
+            CanonArenaRelease( pCG, p->AtNumber );
             p->AtNumber = NULL;
         }
         if (p->Rank)
         {
-            inchi_free( p->Rank );
+            CanonArenaRelease( pCG, p->Rank );
             p->Rank = NULL;
         }
     }
@@ -1060,7 +1091,7 @@ void NodeSetFromVertices( CANON_GLOBALS *pCG, NodeSet *cur_nodes, int l, Node *v
     for (i = 0; i < num_v; i++)
     {
         j = (int) v[i] - 1;
-        Bits[j / pCG->m_num_bit] |= pCG->m_bBit[j % pCG->m_num_bit];
+        Bits[BitWordIndex( j )] |= BitWordBit( j );
     }
 
     INCHI_HEAPCHK
@@ -1114,8 +1145,8 @@ void PartitionGetMcrAndFixSet( CANON_GLOBALS *pCG,
     {
         if (r == ( r1 = ( rank_mask_bit&p->Rank[j1 = (int) p->AtNumber[i]] ) ))
         {
-            FixBits[j1 / pCG->m_num_bit] |= pCG->m_bBit[j1 % pCG->m_num_bit];
-            McrBits[j1 / pCG->m_num_bit] |= pCG->m_bBit[j1 % pCG->m_num_bit];
+            FixBits[BitWordIndex( j1 )] |= BitWordBit( j1 );
+            McrBits[BitWordIndex( j1 )] |= BitWordBit( j1 );
         }
         else
         {
@@ -1126,7 +1157,7 @@ void PartitionGetMcrAndFixSet( CANON_GLOBALS *pCG,
                     j1 = j2;
                 }
             }
-            McrBits[j1 / pCG->m_num_bit] |= pCG->m_bBit[j1 % pCG->m_num_bit];
+            McrBits[BitWordIndex( j1 )] |= BitWordBit( j1 );
         }
     }
 
@@ -1150,7 +1181,7 @@ void NodeSetFromRadEndpoints( CANON_GLOBALS *pCG,
     for (i = 1; i < num_v; i += 2)
     {
         j = (int) RadEndpoints[i];
-        Bits[j / pCG->m_num_bit] |= pCG->m_bBit[j % pCG->m_num_bit];
+        Bits[BitWordIndex( j )] |= BitWordBit( j );
     }
 }
 
@@ -1168,7 +1199,7 @@ void RemoveFromNodeSet( CANON_GLOBALS *pCG,
         for (i = 0; i < num_v; i++)
         {
             j = (int) v[i];
-            Bits[j / pCG->m_num_bit] &= ~pCG->m_bBit[j % pCG->m_num_bit];
+            Bits[BitWordIndex( j )] &= ~BitWordBit( j );
         }
     }
 }
@@ -1249,30 +1280,21 @@ int AddNodesToRadEndpoints( CANON_GLOBALS *pCG,
     if (cur_nodes->bitword)
     {
         bitWord *Bits = cur_nodes->bitword[k];
+        bitWord  w;
         int      len = cur_nodes->len_set;
-        int      i, j;
-        Vertex   v;
+        int      i;
 
-        for (i = 0, v = 0; i < len; i++)
+        for (i = 0; i < len; i++)
         {
-            if (Bits[i])
+            /* visit the set bits only, lowest first */
+            for (w = Bits[i]; w; w &= w - 1)
             {
-                for (j = 0; j < pCG->m_num_bit; j++, v++)
+                if (n >= nLen)
                 {
-                    if (Bits[i] & pCG->m_bBit[j])
-                    {
-                        if (n >= nLen)
-                        {
-                            return -1; /* overflow */
-                        }
-                        RadEndpoints[n++] = vRad;
-                        RadEndpoints[n++] = v;
-                    }
+                    return -1; /* overflow */
                 }
-            }
-            else
-            {
-                v += pCG->m_num_bit;
+                RadEndpoints[n++] = vRad;
+                RadEndpoints[n++] = (Vertex) ( i * BIT_WORD_BITS + BitWordCtz( w ) );
             }
         }
     }
@@ -1781,7 +1803,7 @@ int CellIntersectWithSet( CANON_GLOBALS *pCG,
     for (i = first, k = 0; i < next; i++)
     {
         j = (int) p->AtNumber[i];
-        if (!( McrBits[j / pCG->m_num_bit] & pCG->m_bBit[j % pCG->m_num_bit] ))
+        if (!( McrBits[BitWordIndex( j )] & BitWordBit( j ) ))
         {
             /* BC: reading uninit memory ???-not examined yet */
             k += !( p->Rank[j] & rank_mark_bit ); /* for testing only */
@@ -3149,8 +3171,8 @@ void TranspositionGetMcrAndFixSetAndUnorderedPartition( CANON_GLOBALS *pCG,
 
         if (j == i)
         {
-            FixBits[i / pCG->m_num_bit] |= pCG->m_bBit[i % pCG->m_num_bit];
-            McrBits[i / pCG->m_num_bit] |= pCG->m_bBit[i % pCG->m_num_bit];
+            FixBits[BitWordIndex( i )] |= BitWordBit( i );
+            McrBits[BitWordIndex( i )] |= BitWordBit( i );
             /* p->next[i] = INCHI_CANON_INFINITY; */ /* no link to same orbit points */
             p->equ2[i] = next;  /* fixed point */
         }
@@ -3170,7 +3192,7 @@ void TranspositionGetMcrAndFixSetAndUnorderedPartition( CANON_GLOBALS *pCG,
                 }
                 /* djb-rwth: removing redundant code */
             }
-            McrBits[mcr / pCG->m_num_bit] |= pCG->m_bBit[mcr % pCG->m_num_bit]; /* save mcr */
+            McrBits[BitWordIndex( mcr )] |= BitWordBit( mcr ); /* save mcr */
             /* fill out the unordered partition, the mcr first, other in the cycle after that */
             p->equ2[mcr] = mcr;
             for (k = mcr; mcr != ( j = (int) ( rank_mask_bit & gamma->nAtNumb[k] ) ); k = j)
@@ -3201,74 +3223,149 @@ void TranspositionGetMcrAndFixSetAndUnorderedPartition( CANON_GLOBALS *pCG,
 }
 
 
-/****************************************************************************/
-int SetBitCreate( CANON_GLOBALS *pCG )
+/****************************************************************************
+ Scratch memory arena of CanonGraph() temporaries
+
+ Allocations made between CanonArenaOpen() and the matching
+ CanonArenaClose() are carved from pCG->m_Arena.pBuf; what does not fit
+ goes to the heap and is freed by CanonArenaClose(). When the outermost
+ scope is closed pBuf is grown to the high-water mark so that the next
+ structure of the same or smaller size needs no heap allocations at all.
+ Outside of open scopes CanonArenaAlloc() is plain inchi_malloc/calloc.
+ CanonArenaRelease() frees only memory that does not belong to the arena.
+****************************************************************************/
+void CanonArenaOpen( CANON_GLOBALS *pCG, CANON_ARENA_MARK *pMark )
 {
-    bitWord b1 = 1, b2;
-    AT_NUMB n1, n2;
-#ifdef INCHI_CANON_USE_HASH
-    CtHash  h1, h2;
+    CANON_ARENA *pA = &pCG->m_Arena;
+
+    pMark->nUsed = pA->nUsed;
+    pMark->nDemand = pA->nDemand;
+    pMark->pOverflow = pA->pOverflow;
+#if ( BUILD_WITH_CANON_ARENA == 1 )
+    pA->nOpen++;
 #endif
-    int    i;
+}
 
-    if (pCG->m_bBitInitialized)
+
+/****************************************************************************/
+void CanonArenaClose( CANON_GLOBALS *pCG, CANON_ARENA_MARK *pMark )
+{
+    CANON_ARENA *pA = &pCG->m_Arena;
+    void        *pNext;
+
+    while (pA->pOverflow && pA->pOverflow != pMark->pOverflow)
     {
-        INCHI_HEAPCHK
-        return 0; /* already created */
+        pNext = *(void**) pA->pOverflow;
+        inchi_free( pA->pOverflow );
+        pA->pOverflow = pNext;
+    }
+    pA->nUsed = pMark->nUsed;
+    pA->nDemand = pMark->nDemand;
+#if ( BUILD_WITH_CANON_ARENA == 1 )
+    if (pA->nOpen > 0 && !--pA->nOpen && pA->nHighWater > pA->nSize)
+    {
+        /* all scopes closed: nothing points into pBuf */
+        if (pA->pBuf)
+        {
+            inchi_free( pA->pBuf );
+        }
+        pA->nSize = inchi_min( pA->nHighWater, CANON_ARENA_MAX_SIZE );
+        if (!( pA->pBuf = (char*) inchi_malloc( pA->nSize ) ))
+        {
+            pA->nSize = 0;
+        }
     }
+#endif
+}
 
-    /* djb-rwth: removing redundant code */
-    pCG->m_num_bit = 1;
-    for (b1 = 1, pCG->m_num_bit = 1; b1 < ( b2 = (bitWord) ( ( b1 << 1 )& BIT_WORD_MASK ) ); b1 = b2, pCG->m_num_bit++)
+
+/****************************************************************************/
+void *CanonArenaAlloc( CANON_GLOBALS *pCG, size_t num, size_t size, int bZero )
+{
+    CANON_ARENA *pA = pCG ? &pCG->m_Arena : NULL;
+    size_t       len = ( num * size + CANON_ARENA_ALIGN - 1 ) & ~(size_t) ( CANON_ARENA_ALIGN - 1 );
+    char        *p;
+
+    if (!pA || !pA->nOpen)
     {
-        ;
+        return bZero ? inchi_calloc( num, size ) : inchi_malloc( num * size );
     }
-    pCG->m_bBit = (bitWord*) inchi_calloc( pCG->m_num_bit, sizeof( bitWord ) );
-    if (!pCG->m_bBit)
+    pA->nDemand += len;
+    if (pA->nHighWater < pA->nDemand)
     {
-        INCHI_HEAPCHK
-            return -1; /* failed */
+        pA->nHighWater = pA->nDemand;
     }
-    for (i = 0, b1 = 1; i < pCG->m_num_bit; i++, b1 <<= 1)
+    if (pA->nUsed + len <= pA->nSize)
     {
-        pCG->m_bBit[i] = b1;
+        p = pA->pBuf + pA->nUsed;
+        pA->nUsed += len;
+        pA->lNumArenaAllocs++;
     }
-
-    for (n1 = 1; n1 < ( n2 = (AT_RANK) ( ( n1 << 1 )& AT_RANK_MASK ) ); n1 = n2)
+    else
     {
-        ;
+        /* the block starts with a link to the previous overflow block */
+        if (!( p = (char*) inchi_malloc( CANON_ARENA_ALIGN + len ) ))
+        {
+            return NULL;
+        }
+        *(void**) p = pA->pOverflow;
+        pA->pOverflow = p;
+        p += CANON_ARENA_ALIGN;
+        pA->lNumHeapAllocs++;
     }
-    rank_mark_bit = n1;
-    rank_mask_bit = ~n1;
-
-#ifdef INCHI_CANON_USE_HASH
-    for (h1 = 1; h1 < ( h2 = ( h1 << 1 ) ); h1 = h2)
+    if (bZero)
     {
-        ;
+        memset( p, 0, num * size ); /* djb-rwth: memset_s C11/Annex K variant? */
     }
-    hash_mark_bit = h1;
-#endif
-    pCG->m_bBitInitialized = 1;
-    INCHI_HEAPCHK
 
-    return 1;
+    return p;
 }
 
 
 /****************************************************************************/
-int SetBitFree( CANON_GLOBALS *pCG )
+void CanonArenaRelease( CANON_GLOBALS *pCG, void *p )
 {
-    if (pCG->m_bBit)
+    CANON_ARENA *pA = pCG ? &pCG->m_Arena : NULL;
+    void        *q;
+
+    if (!p)
     {
-        inchi_free( pCG->m_bBit );
-        pCG->m_bBit = NULL;
-        INCHI_HEAPCHK
-        return 1; /* success */
+        return;
+    }
+    if (pA)
+    {
+        if (pA->pBuf && (char*) p >= pA->pBuf && (char*) p < pA->pBuf + pA->nSize)
+        {
+            return; /* returned to the arena by CanonArenaClose() */
+        }
+        for (q = pA->pOverflow; q; q = *(void**) q)
+        {
+            if ((char*) q + CANON_ARENA_ALIGN == (char*) p)
+            {
+                return; /* freed by CanonArenaClose() */
+            }
+        }
     }
+    inchi_free( p );
+}
 
-    INCHI_HEAPCHK
 
-    return 0; /* already destroyed */
+/****************************************************************************/
+void CanonArenaFree( CANON_GLOBALS *pCG )
+{
+    CANON_ARENA      *pA = &pCG->m_Arena;
+    CANON_ARENA_MARK  Empty;
+
+    memset( &Empty, 0, sizeof( Empty ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    pA->nOpen = 1;
+    pA->nHighWater = 0;
+    CanonArenaClose( pCG, &Empty );
+    if (pA->pBuf)
+    {
+        inchi_free( pA->pBuf );
+        pA->pBuf = NULL;
+    }
+    pA->nSize = 0;
 }
 
 
@@ -3542,7 +3639,7 @@ int  GetCanonRanking2( int num_atoms,
     RearrangeAtRankArray( n, nSymmRank, old2new, mark, 32 );
 
     /* free memory */
-    CTableFree( pzb_rho );
+    CTableFree( NULL, pzb_rho );
     if (pzb_rho)
     {
         inchi_free( pzb_rho );
@@ -3775,6 +3872,7 @@ int CanonGraph( INCHI_CLOCK *ic,
     NodeSet cur_nodes;   /* 1 each */
 
     Transposition gamma;
+    CANON_ARENA_MARK ArenaMark; /* scratch memory of this call */
 
     Partition zeta;      /* the first discovered terminal node */
     Partition rho;       /* the best discovered terminal node */
@@ -3818,10 +3916,6 @@ int CanonGraph( INCHI_CLOCK *ic,
 
     /* memory allocation */
 
-    if (0 > SetBitCreate( pCG ))
-    {
-        return -1;
-    }
     if (pzb_rho_fix && pzb_rho_fix->nLenCTAtOnly != pCD->nLenCTAtOnly)
     {
         /* consistency check */
@@ -3829,13 +3923,15 @@ int CanonGraph( INCHI_CLOCK *ic,
     }
     ok = 1;
 
-    ok &= UnorderedPartitionCreate( &theta, n_tg );
-    ok &= UnorderedPartitionCreate( &theta_from_gamma, n_tg );
+    CanonArenaOpen( pCG, &ArenaMark );
+
+    ok &= UnorderedPartitionCreate( pCG, &theta, n_tg );
+    ok &= UnorderedPartitionCreate( pCG, &theta_from_gamma, n_tg );
 
     /* djb-rwth: fixing dereferencing NULL pointer and buffer overflows */
-    W = (Cell*) inchi_calloc( n_tg, sizeof( W[0] ) );
-    v = (Node*) inchi_calloc( n_tg, sizeof( v[0] ) );
-    e = (S_CHAR*) inchi_calloc( n_tg, sizeof( e[0] ) );
+    W = (Cell*) CanonArenaAlloc( pCG, n_tg, sizeof( W[0] ), 1 );
+    v = (Node*) CanonArenaAlloc( pCG, n_tg, sizeof( v[0] ), 1 );
+    e = (S_CHAR*) CanonArenaAlloc( pCG, n_tg, sizeof( e[0] ), 1 );
 
     if (!W || !v || !e)
     {
@@ -3853,18 +3949,19 @@ int CanonGraph( INCHI_CLOCK *ic,
     */
 
     /*    ok &= (NULL != (qzb = (S_CHAR*)inchi_calloc( n_tg, sizeof(W[0])))); */
-    ok &= CTableCreate( &Lambda, n, pCD );
-    ok &= CTableCreate( &zf_zeta, n, pCD );
+    ok &= CTableCreate( pCG, &Lambda, n, pCD );
+    ok &= CTableCreate( pCG, &zf_zeta, n, pCD );
+    /* pzb_rho may be returned in *pp_zb_rho_out: not from the arena */
     ok &= ( ( pzb_rho = (ConTable *) inchi_calloc( 1, sizeof( *pzb_rho ) ) ) &&
-            CTableCreate( pzb_rho, n, pCD ) );
+            CTableCreate( NULL, pzb_rho, n, pCD ) );
 
     ok &= NodeSetCreate( pCG, &Omega, n_tg, L_curr_max_set_size );
     ok &= NodeSetCreate( pCG, &Phi, n_tg, L_curr_max_set_size );
     ok &= NodeSetCreate( pCG, &cur_nodes, n_tg, 1 );
 
-    ok &= PartitionCreate( &zeta, n_tg );
-    ok &= PartitionCreate( &rho, n_tg );
-    ok &= TranspositionCreate( &gamma, n_tg );
+    ok &= PartitionCreate( pCG, &zeta, n_tg );
+    ok &= PartitionCreate( pCG, &rho, n_tg );
+    ok &= TranspositionCreate( pCG, &gamma, n_tg );
 
     INCHI_HEAPCHK
 
@@ -4622,29 +4719,29 @@ exit_function:
 exit_error:
     INCHI_HEAPCHK
 
-    UnorderedPartitionFree( &theta );
-    UnorderedPartitionFree( &theta_from_gamma );
+    UnorderedPartitionFree( pCG, &theta );
+    UnorderedPartitionFree( pCG, &theta_from_gamma );
     if (W)
     {
-        inchi_free( W );
+        CanonArenaRelease( pCG, W );
     }
     if (v)
     {
-        inchi_free( v );
+        CanonArenaRelease( pCG, v );
     }
     if (e)
     {
-        inchi_free( e );
+        CanonArenaRelease( pCG, e );
     }
     if (qzb)
     {
-        inchi_free( qzb );
+        CanonArenaRelease( pCG, qzb );
     }
-    CTableFree( &Lambda );
-    CTableFree( &zf_zeta );
+    CTableFree( pCG, &Lambda );
+    CTableFree( pCG, &zf_zeta );
     if (pzb_rho)
     {
-        CTableFree( pzb_rho );
+        CTableFree( NULL, pzb_rho );
         inchi_free( pzb_rho );
         pzb_rho = NULL;
     }
@@ -4653,10 +4750,12 @@ exit_error:
     NodeSetFree( pCG, &Phi );
     /* NodeSetFree( &mcr_theta, n, 1 ); */
     NodeSetFree( pCG, &cur_nodes );
-    PartitionFree( &zeta );
+    PartitionFree( pCG, &zeta );
     /* PartitionFree( &zeta2 ); */
-    PartitionFree( &rho );
-    TranspositionFree( &gamma );
+    PartitionFree( pCG, &rho );
+    TranspositionFree( pCG, &gamma );
+
+    CanonArenaClose( pCG, &ArenaMark );
 
     return ret;
 }
@@ -4688,6 +4787,14 @@ int SetInitialRanks2( int num_atoms,
     /* global for qsort */
     pCG->m_pAtomInvariant2ForSort = pAtomInvariant2;
 
+#if ( BUILD_WITH_RADIX_SORT == 1 )
+    if (num_atoms >= RADIX_SORT_MIN_ATOMS &&
+         ( nNumDiffRanks = SortAtomInvariants2( num_atoms, pAtomInvariant2, nNewRank, nAtomNumber ) ))
+    {
+        return nNumDiffRanks; /* sorted and ranked by packed integer keys */
+    }
+#endif
+
     inchi_qsort( pCG, nAtomNumber, num_atoms, sizeof( nAtomNumber[0] ), CompAtomInvariants2 );
 
     /* nNewRank[i]: non-decreading order; do not increment nCurrentRank */
@@ -4952,7 +5059,7 @@ void MergeCleanIsoSortKeys( AT_ISO_SORT_KEY * isk1, AT_ISO_SORT_KEY * isk2, int
 #endif
 
 
-#define FREE_CONTABLE( X) if (X) {CTableFree( X);inchi_free( X);}
+#define FREE_CONTABLE( X) if (X) {CTableFree( NULL, X);inchi_free( X);}
 #define FREE_ARRAY( X) if (X) inchi_free( X);
 
 
@@ -4980,7 +5087,7 @@ void DeAllocBCN( BCN *pBCN )
 
         FREE_ARRAY( ftcn->LinearCt )
 
-        PartitionFree( &ftcn->PartitionCt );
+        PartitionFree( NULL, &ftcn->PartitionCt );
 
         FREE_ARRAY( ftcn->nSymmRankCt )
         FREE_ARRAY( ftcn->nNumHOrig )
@@ -4988,7 +5095,7 @@ void DeAllocBCN( BCN *pBCN )
         FREE_ARRAY( ftcn->nNumHOrigFixH )
         FREE_ARRAY( ftcn->nNumHFixH )
 
-        PartitionFree( &ftcn->PartitionCtIso );
+        PartitionFree( NULL, &ftcn->PartitionCtIso );
 
         FREE_ARRAY( ftcn->nSymmRankCtIso )
         FREE_ARRAY( ftcn->iso_sort_keys )
@@ -5467,7 +5574,7 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
     {
         if (Ct_NoH)
         {
-            CTableFree( Ct_NoH );
+            CTableFree( NULL, Ct_NoH );
             inchi_free( Ct_NoH );
             Ct_NoH = NULL;
         }
@@ -5608,7 +5715,7 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
         /* copy the results of the previous (no H) canonicalization */
         /* in this case numHNoTautH[] is not needed for the next canonicalization(s) */
         if (( Ct_Temp = (ConTable *) inchi_calloc( 1, sizeof( *Ct_Temp ) ) ) &&
-             CTableCreate( Ct_Temp, num_atoms, pCD + iOther ))
+             CTableCreate( NULL, Ct_Temp, num_atoms, pCD + iOther ))
         {
             CtFullCopy( Ct_Temp, Ct_NoH );
             /* since Ct_NoH does not have Ct_NoH->NumH we have to fill out Ct_Temp->NumH separately */
@@ -5782,7 +5889,7 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
             /* copy the results of the previous (no taut H) canonicalization */
             /* in this case numHNoTautH[] is not needed for the next canonicalization(s) */
             if (( Ct_Temp = (ConTable *) inchi_calloc( 1, sizeof( *Ct_Temp ) ) ) &&
-                 CTableCreate( Ct_Temp, num_atoms, pCD + iOther ))
+                 CTableCreate( NULL, Ct_Temp, num_atoms, pCD + iOther ))
             {
                 CtFullCopy( Ct_Temp, Ct_NoTautH );
                 /* since Ct_NoTautH does not have Ct_NoTautH->iso_sort_key we have to fill out Ct_Temp->iso_sort_key separately */
@@ -6191,7 +6298,7 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
                     /* copy the results of the previous (no taut H) canonicalization */
                     /* in this case numHNoTautH[] is not needed for the next canonicalization(s) */
                     if (( Ct_Temp = (ConTable *) inchi_calloc( 1, sizeof( *Ct_Temp ) ) ) &&
-                         CTableCreate( Ct_Temp, num_atoms, pCD + iBase ))
+                         CTableCreate( NULL, Ct_Temp, num_atoms, pCD + iBase ))
                     {
                         CtFullCopy( Ct_Temp, Ct_Base );
                         /* since Ct_Base does not have Ct_Base->iso_sort_key we
@@ -6304,50 +6411,100 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
 
         pCD[iOther].nAuxRank = NULL;
 
-#if ( USE_AUX_RANKING == 1 )
-        if (!nRankAux)
-        {
-            nRankAux = (AT_RANK *) inchi_calloc( num_max, sizeof( nRankAux[0] ) );
-        }
-        if (!nAtomNumberAux)
-        {
-            nAtomNumberAux = (AT_NUMB *) inchi_calloc( num_max, sizeof( nAtomNumberAux[0] ) );
-        }
-        if (!pAtomInvariantAux)
+#if ( REUSE_NO_TAUT_H_PARTITION == 1 )
+        /* check whether we need fixed-H canonicalization: v. 1.07+ */
+        /* if NumHfixed[] is constant on each NoTautH equivalence class then every
+           automorphism of the NoTautH structure preserves it; the NoTautH canonical
+           numbering and equivalence partition are also the fixed-H ones */
+        memset( nTempRank, 0, num_max * sizeof( nTempRank[0] ) );
+        for (i = 0; i < num_atoms; i++)
         {
-            pAtomInvariantAux = (ATOM_INVARIANT2 *) inchi_malloc( num_max * sizeof( pAtomInvariantAux[0] ) );
+            if (nTempRank[nSymmRankNoTautH[i] - 1] < i)
+            {
+                nTempRank[nSymmRankNoTautH[i] - 1] = i; /* greatest class representative */
+            }
         }
-        if (!nRankAux || !nAtomNumberAux || !pAtomInvariantAux)
+        for (i = 0; i < num_atoms; i++)
         {
-            goto exit_error_alloc;
+            if (NumHfixed[i] != NumHfixed[nTempRank[nSymmRankNoTautH[i] - 1]])
+            {
+                break; /* atoms so far found to be equivalent have different number of fixed H; the canonicalization is needed */
+            }
         }
+#else
+        i = 0;
+#endif
 
-        /* refine no-H partition according to non-taut H distribution */
-        memset( pAtomInvariantAux, 0, num_max * sizeof( pAtomInvariantAux[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
-        for (i = 0; i < num_atoms; i++)
+        if (i < num_atoms)
         {
-            pAtomInvariantAux[i].val[0] = nSymmRankBase[i];
-            pAtomInvariantAux[i].val[1] = NumHfixed[i]; /* additional differentiation */
-        }
+#if ( USE_AUX_RANKING == 1 )
+            if (!nRankAux)
+            {
+                nRankAux = (AT_RANK *) inchi_calloc( num_max, sizeof( nRankAux[0] ) );
+            }
+            if (!nAtomNumberAux)
+            {
+                nAtomNumberAux = (AT_NUMB *) inchi_calloc( num_max, sizeof( nAtomNumberAux[0] ) );
+            }
+            if (!pAtomInvariantAux)
+            {
+                pAtomInvariantAux = (ATOM_INVARIANT2 *) inchi_malloc( num_max * sizeof( pAtomInvariantAux[0] ) );
+            }
+            if (!nRankAux || !nAtomNumberAux || !pAtomInvariantAux)
+            {
+                goto exit_error_alloc;
+            }
 
-        /* initial ranks for t-group(s) */
-        nNumCurrRanks = SetInitialRanks2( num_atoms, pAtomInvariantAux, nRankAux, nAtomNumberAux, pCG );
+            /* refine no-H partition according to non-taut H distribution */
+            memset( pAtomInvariantAux, 0, num_max * sizeof( pAtomInvariantAux[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+            for (i = 0; i < num_atoms; i++)
+            {
+                pAtomInvariantAux[i].val[0] = nSymmRankBase[i];
+                pAtomInvariantAux[i].val[1] = NumHfixed[i]; /* additional differentiation */
+            }
 
-        /* make equitable, digraph procedure */
-        nNumCurrRanks = DifferentiateRanks2( pCG, num_atoms, NeighList[TAUT_NON],
-                                            nNumCurrRanks, nRankAux,
-                                            nTempRank, nAtomNumberAux, &lCount, 0 /* 0 means use qsort */ ); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
-        /* to accelerate do not call CanonGraph() to find really equivalent atoms */
-        pCD[iOther].nAuxRank = nRankAux;
+            /* initial ranks for t-group(s) */
+            nNumCurrRanks = SetInitialRanks2( num_atoms, pAtomInvariantAux, nRankAux, nAtomNumberAux, pCG );
+
+            /* make equitable, digraph procedure */
+            nNumCurrRanks = DifferentiateRanks2( pCG, num_atoms, NeighList[TAUT_NON],
+                                                nNumCurrRanks, nRankAux,
+                                                nTempRank, nAtomNumberAux, &lCount, 0 /* 0 means use qsort */ ); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
+            /* to accelerate do not call CanonGraph() to find really equivalent atoms */
+            pCD[iOther].nAuxRank = nRankAux;
 #endif
 
-        ret = CanonGraph07( ic, pCG, num_atoms, num_atoms, num_max, 0,
-                            NeighList[TAUT_NON], (Partition *) pBCN->pRankStack,
-                            nSymmRankFixH, nCanonRankFixH, nAtomNumberCanonFixH,
-                            pCD + iOther, pCC, &Ct_NoTautH, &Ct_FixH, LargeMolecules );
-        if (ret < 0)
+            ret = CanonGraph07( ic, pCG, num_atoms, num_atoms, num_max, 0,
+                                NeighList[TAUT_NON], (Partition *) pBCN->pRankStack,
+                                nSymmRankFixH, nCanonRankFixH, nAtomNumberCanonFixH,
+                                pCD + iOther, pCC, &Ct_NoTautH, &Ct_FixH, LargeMolecules );
+            if (ret < 0)
+            {
+                goto exit_error;
+            }
+        }
+        else
         {
-            goto exit_error;
+            /* copy the results of the previous (no taut H) canonicalization */
+            if (( Ct_Temp = (ConTable *) inchi_calloc( 1, sizeof( *Ct_Temp ) ) ) &&
+                 CTableCreate( NULL, Ct_Temp, num_atoms, pCD + iOther ))
+            {
+                CtFullCopy( Ct_Temp, Ct_NoTautH );
+                /* since Ct_NoTautH does not have Ct_NoTautH->NumHfixed we have to fill out Ct_Temp->NumHfixed separately */
+                for (i = 0; i < num_atoms; i++)
+                {
+                    Ct_Temp->NumHfixed[nCanonRankNoTautH[i] - 1] = NumHfixed[i];
+                }
+            }
+            else
+            {
+                goto exit_error_alloc;
+            }
+            Ct_FixH = Ct_Temp;
+            Ct_Temp = NULL;
+            memcpy( nSymmRankFixH, nSymmRankNoTautH, num_atoms * sizeof( nSymmRankFixH[0] ) );
+            memcpy( nCanonRankFixH, nCanonRankNoTautH, num_atoms * sizeof( nCanonRankFixH[0] ) );
+            memcpy( nAtomNumberCanonFixH, nAtomNumberCanonNoTautH, num_atoms * sizeof( nAtomNumberCanonFixH[0] ) );
         }
 
         /*******************************************************************************************/
@@ -6580,7 +6737,7 @@ int GetBaseCanonRanking( INCHI_CLOCK *ic,
                 /* copy the results of the previous (no taut H) canonicalization */
                 /* in this case numHNoTautH[] is not needed for the next canonicalization(s) */
                 if (( Ct_Temp = (ConTable *) inchi_calloc( 1, sizeof( *Ct_Temp ) ) ) &&
-                     CTableCreate( Ct_Temp, num_atoms, pCD + iOther ))
+                     CTableCreate( NULL, Ct_Temp, num_atoms, pCD + iOther ))
                 {
                     CtFullCopy( Ct_Temp, Ct_FixH );
                     /* since Ct_FixH does not have Ct_FixH->iso_sort_key and Ct_FixH->iso_sort_key_Hfixed we
@@ -6827,7 +6984,7 @@ exit_error:
 
 exit_function:
 
-#define FREE_CONTABLE( X) if (X) {CTableFree( X);inchi_free( X);}
+#define FREE_CONTABLE( X) if (X) {CTableFree( NULL, X);inchi_free( X);}
 #define FREE_ARRAY( X) if (X) inchi_free( X);
 
     FreeNeighList( NeighList[TAUT_NON] );
@@ -107,6 +107,19 @@ static clock_t InchiClock( void )
     }
     return 0;
 }
+#elif ( BUILD_WITH_THREADS == 1 ) && defined(CLOCK_THREAD_CPUTIME_ID)
+/* clock() counts CPU time of all threads of the process; in */
+/* multi-threaded mode use the time consumed by calling thread only */
+static clock_t InchiClock( void )
+{
+    struct timespec ts;
+    if (!clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ))
+    {
+        return (clock_t) ts.tv_sec * CLOCKS_PER_SEC
+             + (clock_t) ( ts.tv_nsec / ( 1000000000L / CLOCKS_PER_SEC ) );
+    }
+    return 0;
+}
 #else
 static clock_t InchiClock( void )
 {
@@ -1145,7 +1158,7 @@ int UpdateFullLinearCT( int num_atoms,
         }
         pCG->m_pNeighborsForSort = at[i].neighbor;
         pCG->m_pn_RankForSort = nRank;
-        insertions_sort( pCG, nNeighborNumber, (size_t) num_neigh, sizeof( nNeighborNumber[0] ), CompNeighborsAT_NUMBER );
+        insertions_sort_AT_NUMB_by_NeighRank( nNeighborNumber, num_neigh, at[i].neighbor, nRank );
 
         for (k = 0; k < num_neigh; k++)
         {
@@ -1207,7 +1220,7 @@ int UpdateFullLinearCT( int num_atoms,
         pCG->m_pn_RankForSort = nRank;
         if (t_group + i) /* djb-rwth: ignoring GCC warning */
             num_neigh = (int)t_group[i].nNumEndpoints;
-        insertions_sort( pCG, nEndpointAtomNumber, (size_t) num_neigh, sizeof( nEndpointAtomNumber[0] ), CompRank );
+        insertions_sort_AT_NUMB_by_Rank( nEndpointAtomNumber, num_neigh, nRank );
 
         for (k = 0; k < num_neigh; k++)
         {
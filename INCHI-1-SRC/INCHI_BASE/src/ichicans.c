@@ -381,7 +381,7 @@ int UnmarkNonStereo( CANON_GLOBALS *pCG,
                         /*  sort neighbors according to their canon. equivalence ranks */
                         pCG->m_pNeighborsForSort = at[jc].neighbor;
                         pCG->m_pn_RankForSort = nRank;
-                        insertions_sort( pCG, nNeighborNumber, val, sizeof( nNeighborNumber[0] ), CompNeighborsAT_NUMBER );
+                        insertions_sort_AT_NUMB_by_NeighRank( nNeighborNumber, val, at[jc].neighbor, nRank );
                         num_neighbors_with_parity = -1; /*  non-zero */
                         for (k = k1 = 0, nPrevNeighRank = 0; k <= val; k++)
                         {
@@ -564,7 +564,7 @@ int FillSingleStereoDescriptors( CANON_GLOBALS  *pCG,
 
             pCG->m_pNeighborsForSort = at[i].neighbor;
             pCG->m_pn_RankForSort = nRank;
-            num_trans = insertions_sort( pCG, nNeighborNumber2, num_neigh, sizeof( nNeighborNumber2[0] ), CompNeighborsAT_NUMBER );
+            num_trans = insertions_sort_AT_NUMB_by_NeighRank( nNeighborNumber2, num_neigh, at[i].neighbor, nRank );
 
 #ifndef CT_NEIGH_INCREASE
             num_trans += ( ( num_neigh*( num_neigh - 1 ) ) / 2 ) % 2;  /*  get correct parity for ascending order */
@@ -594,7 +594,7 @@ int FillSingleStereoDescriptors( CANON_GLOBALS  *pCG,
             /*  sort stereo bonds according to the ranks of the neighbors */
             pCG->m_pNeighborsForSort = nStereoNeigh;
             pCG->m_pn_RankForSort = nRank;
-            insertions_sort( pCG, nStereoNeighNumber, num_stereo, sizeof( nStereoNeighNumber[0] ), CompNeighborsAT_NUMBER );
+            insertions_sort_AT_NUMB_by_NeighRank( nStereoNeighNumber, num_stereo, nStereoNeigh, nRank );
 
             /*  process stereo bonds one by one */
             for (k = 0; k < num_stereo; k++)
@@ -891,7 +891,7 @@ int SetKnownStereoBondParities( CANON_GLOBALS *pCG,
                     /*  neighbors are constitutionally identical, can't find bond parity */
                     continue;
                 }
-                trans_i1 = insertions_sort( pCG, nNeighRank1, j, sizeof( nNeighRank1[0] ), comp_AT_RANK );
+                trans_i1 = insertions_sort_AT_RANK( nNeighRank1, j );
             }
 
             /*  store ranks of at[i2] stereo bond neighbors except one connected by a stereo bond */
@@ -913,7 +913,7 @@ int SetKnownStereoBondParities( CANON_GLOBALS *pCG,
                     /*  neighbors are constitutionally identical, can't find bond parity */
                     continue;
                 }
-                trans_i2 = insertions_sort( pCG, nNeighRank2, j, sizeof( nNeighRank2[0] ), comp_AT_RANK );
+                trans_i2 = insertions_sort_AT_RANK( nNeighRank2, j );
             }
 
             prev_trans = -1;
@@ -991,7 +991,7 @@ int SetKnownStereoBondParities( CANON_GLOBALS *pCG,
                     }
                     if (j == 2)
                     {
-                        trans_k1 = insertions_sort( pCG, nNeighCanonRank1, j, sizeof( nNeighCanonRank1[0] ), comp_AT_RANK );
+                        trans_k1 = insertions_sort_AT_RANK( nNeighCanonRank1, j );
                     }
                     else
                     {
@@ -1026,7 +1026,7 @@ int SetKnownStereoBondParities( CANON_GLOBALS *pCG,
                     }
                     if (j == 2)
                     {
-                        trans_k2 = insertions_sort( pCG, nNeighCanonRank2, j, sizeof( nNeighCanonRank2[0] ), comp_AT_RANK );
+                        trans_k2 = insertions_sort_AT_RANK( nNeighCanonRank2, j );
                     }
                     else
                     {
@@ -1749,7 +1749,7 @@ int SetKnownStereoCenterParities( CANON_GLOBALS *pCG,
         else
         {
             /* sort constitutional equivalence ranks of the neighbors */
-            trans_i = insertions_sort( pCG, nNeighRank, num_neigh, sizeof( nNeighRank[0] ), comp_AT_RANK );
+            trans_i = insertions_sort_AT_RANK( nNeighRank, num_neigh );
             for (j = 1; j < num_neigh; j++)
             {
                 if (nNeighRank[j - 1] == nNeighRank[j])
@@ -1800,7 +1800,7 @@ int SetKnownStereoCenterParities( CANON_GLOBALS *pCG,
             {
                 return CT_STEREOCOUNT_ERR;  /*   <BRKPT> */
             }
-            trans_k = insertions_sort( pCG, nNeighCanonRank, num_neigh, sizeof( nNeighCanonRank[0] ), comp_AT_RANK );
+            trans_k = insertions_sort_AT_RANK( nNeighCanonRank, num_neigh );
             trans_k %= 2;
             if (prev_trans < 0)
             {
@@ -2315,7 +2315,7 @@ int GetPermutationParity( CANON_GLOBALS *pCG,
         }
         if (k)
         {
-            parity = insertions_sort( pCG, nNeighRank, k, sizeof( nNeighRank[0] ), comp_AT_RANK );
+            parity = insertions_sort_AT_RANK( nNeighRank, k );
             if (nNeighRank[0])
             {
                 parity = 2 - parity % 2;
@@ -2368,7 +2368,7 @@ int GetStereoCenterParity( CANON_GLOBALS *pCG,
         }
         pCG->m_pNeighborsForSort = at[i].neighbor;
         pCG->m_pn_RankForSort = nRank;
-        num_trans = insertions_sort( pCG, nNeighborNumber2, num_neigh, sizeof( nNeighborNumber2[0] ), CompNeighborsAT_NUMBER );
+        num_trans = insertions_sort_AT_NUMB_by_NeighRank( nNeighborNumber2, num_neigh, at[i].neighbor, nRank );
 #ifndef CT_NEIGH_INCREASE
         num_trans += ( ( num_neigh*( num_neigh - 1 ) ) / 2 ) % 2;  /*  get correct parity for ascending order */
 #endif
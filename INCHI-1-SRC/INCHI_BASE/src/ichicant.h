@@ -45,6 +45,7 @@
 
 #include "ichisize.h"
 #include "ichinorm.h"
+#include "ichiring.h"
 
 
 /*
@@ -139,6 +140,10 @@ typedef struct tagAtomInvariant2 {
     S_CHAR          iso_aux_key;
 } ATOM_INVARIANT2;
 
+/* v. 1.07+: ATOM_INVARIANT2 packed into one integer sort key (SortAtomInvariants2) */
+typedef unsigned long long AT_INV_KEY;
+#define AT_INV_KEY_BITS 64
+
 /******************* Partition **********************************/
 typedef struct tagPartition {
     AT_RANK *Rank;
@@ -209,6 +214,7 @@ typedef struct tagCanonStat {
     long                 lNumDecreasedCT;
     long                 lNumRejectedCT;
     long                 lNumEqualCT;
+    long                 lNumStereoMappings; /* v. 1.07+: atom mappings tried by map_stereo_bonds4/atoms4 */
     struct tagInchiTime *ulTimeOutTime;
     long                 lTotalTime;
 
@@ -334,6 +340,49 @@ typedef struct tagCanonStat {
 
 
 
+/* v. 1.07+: scratch memory for the temporary arrays of CanonGraph();   */
+/* one per CANON_GLOBALS, i.e. per thread; it is grown to the high-water */
+/* mark of the largest call and reused by all subsequent calls          */
+typedef struct tagCanonArena
+{
+    char   *pBuf;            /* reusable block */
+    size_t  nSize;           /* allocated length of pBuf */
+    size_t  nUsed;           /* bytes of pBuf currently handed out */
+    size_t  nDemand;         /* bytes requested in the open scopes, including heap overflow */
+    size_t  nHighWater;      /* max. nDemand; pBuf is grown to it once all scopes are closed */
+    void   *pOverflow;       /* heap blocks requested when pBuf was too small */
+    int     nOpen;           /* number of open CanonArenaOpen() scopes */
+    long    lNumArenaAllocs; /* allocations served from pBuf, i.e. malloc/free pairs avoided */
+    long    lNumHeapAllocs;  /* allocations in open scopes that went to the heap */
+} CANON_ARENA;
+
+typedef struct tagCanonArenaMark
+{
+    size_t  nUsed;
+    size_t  nDemand;
+    void   *pOverflow;
+} CANON_ARENA_MARK;
+
+/* v. 1.07+: processing statistics of one thread, see RunStatAddCG() */
+typedef struct tagRunStat
+{
+    /* balanced network search, see mark_alt_bonds_and_taut_groups() */
+    long    lNumPrescreened;        /* normalizations that did not need the search */
+    long    lNumSearched;           /* normalizations that ran it */
+    long    lNumRecordsPrescreened; /* records none of whose normalizations needed it */
+    /* scratch memory arena, see CANON_ARENA */
+    long    lNumArenaAllocs;        /* allocations served from the arena */
+    long    lNumArenaHeapAllocs;    /* allocations that went to the heap */
+    size_t  nArenaSize;             /* largest arena */
+    /* balanced network buffers, see BNS_POOL */
+    long    lNumBnsReused;          /* BN_STRUCT/BN_DATA served from the pool */
+    long    lNumBnsAllocated;       /* pooled arrays that had to be (re)allocated */
+    /* stereo canonicalization, see CANON_STAT */
+    long    lNumStereoMappings;     /* atom mappings tried by map_stereo_bonds4/atoms4 */
+} RUN_STAT;
+
+struct tagBnsPool;
+
 typedef struct tagCANON_GLOBALS
 {
     const NEIGH_LIST      *m_pNeighList_RankForSort;
@@ -342,12 +391,19 @@ typedef struct tagCANON_GLOBALS
     const AT_RANK         *m_pn_RankForSort;
     AT_RANK m_nMaxAtNeighRankForSort;
     int m_nNumCompNeighborsRanksCountEql;
-    bitWord *m_bBit;
-    int m_bBitInitialized;
-    int m_num_bit;
+    CANON_ARENA m_Arena;     /* v. 1.07+ */
+    struct tagBnsPool *m_pBnsPool; /* v. 1.07+: balanced network buffers, see ichi_bns.c */
+    RING_CACHE m_RingCache;  /* v. 1.07+: min. ring sizes of bonds, see ichiring.c */
+    RUN_STAT m_RunStat;      /* v. 1.07+ */
 } CANON_GLOBALS;
 
-int  SetBitCreate( struct tagCANON_GLOBALS *pCG );
+void  CanonArenaOpen( struct tagCANON_GLOBALS *pCG, CANON_ARENA_MARK *pMark );
+void  CanonArenaClose( struct tagCANON_GLOBALS *pCG, CANON_ARENA_MARK *pMark );
+void *CanonArenaAlloc( struct tagCANON_GLOBALS *pCG, size_t num, size_t size, int bZero );
+void  CanonArenaRelease( struct tagCANON_GLOBALS *pCG, void *p );
+
+void  RunStatAdd( RUN_STAT *pTo, const RUN_STAT *pFrom );
+void  RunStatAddCG( RUN_STAT *pTo, const struct tagCANON_GLOBALS *pCG );
 
 void inchi_qsort( void *pParam, void *base, size_t num, size_t width, int( *comp )( const void *, const void *, void * ) );
 
@@ -83,6 +83,10 @@ extern "C" {
     void insertions_sort_NeighList_AT_NUMBERS( NEIGH_LIST base, AT_RANK *nRank );
     int insertions_sort_NeighList_AT_NUMBERS3( NEIGH_LIST base, AT_RANK *nRank );
     int insertions_sort_AT_RANK( AT_RANK *base, int num );
+    int insertions_sort_AT_NUMB_by_Rank( AT_NUMB *base, int num, const AT_RANK *nRank );
+    int insertions_sort_AT_NUMB_by_NeighRank( AT_NUMB *base, int num, const AT_NUMB *nNeigh, const AT_RANK *nRank );
+    int insertions_sort_AT_NUMBERS_NeighLists( AT_NUMB *base, int num, NEIGH_LIST *NeighList, const AT_RANK *nRank );
+    int insertions_sort_AT_NUMBERS_NeighListsUpToMaxRank( AT_NUMB *base, int num, NEIGH_LIST *NeighList, const AT_RANK *nRank, AT_RANK nMaxAtRank );
     void insertions_sort_NeighListBySymmAndCanonRank( NEIGH_LIST base, const AT_RANK *nSymmRank, const AT_RANK *nCanonRank );
     int CompareNeighListLex( NEIGH_LIST pp1, NEIGH_LIST pp2, const AT_RANK *nRank );
     int CompareNeighListLexUpToMaxRank( NEIGH_LIST pp1, NEIGH_LIST pp2, const AT_RANK *nRank, AT_RANK nMaxAtNeighRank );
@@ -94,6 +98,10 @@ extern "C" {
 
     int CompAtomInvariants2Only( const void* a1, const void* a2, void *p );
     int CompAtomInvariants2( const void* a1, const void* a2, void *p );
+#if ( BUILD_WITH_RADIX_SORT == 1 )
+    int SortAtomInvariants2( int num_atoms, const ATOM_INVARIANT2 *pAtomInvariant2,
+                             AT_RANK *nNewRank, AT_RANK *nAtomNumber );
+#endif
 
     int CompNeighListRanks( const void* a1, const void* a2, void *p );
     int CompNeighListRanksOrd( const void* a1, const void* a2, void *p );
@@ -127,6 +135,8 @@ extern "C" {
                                  AT_RANK *nAtomNumber, AT_RANK nMaxAtRank );
     void SortNeighListsBySymmAndCanonRank( int num_atoms, NEIGH_LIST *NeighList, const AT_RANK *nSymmRank, const AT_RANK *nCanonRank );
     int SortNeighLists2( int num_atoms, AT_RANK *nRank, NEIGH_LIST *NeighList, AT_RANK *nAtomNumber );
+    /* v. 1.07+: bUseAltSort bit of DifferentiateRanks2/Basic: change-driven refinement (stereo mapping) */
+#define DIFF_RANKS_QUEUE 2
     int  DifferentiateRanks2( CANON_GLOBALS *pCG, int num_atoms, NEIGH_LIST *NeighList,
                                      int nNumCurrRanks, AT_RANK *pnCurrRank, AT_RANK *pnPrevRank,
                                      AT_RANK *nAtomNumber, long *lNumIter, int bUseAltSort );
@@ -186,6 +186,12 @@ typedef struct tagInputParms {
     int             bMergeHash;             /* v. 1.06+ Combine InChIKey with extra hash(es) if present             */
     int             bNoWarnings;            /* v. 1.06+ suppress warning messages                                   */
     int             bHideInChI;             /* v. 1.06+ Do not print InChI itself                                   */
+    int             nNumThreads;            /* v. 1.07+ number of worker threads (0 or 1=>serial, -1=>one per CPU)  */
+    int             nNumCompThreads;        /* v. 1.07+ threads per structure for its components (same meaning)     */
+    int             bBuildIndex;            /* v. 1.07+ write index of the input SDfile records and exit            */
+    int             nShard;                 /* v. 1.07+ process only byte range shard nShard of nNumShards          */
+    int             nNumShards;             /* v. 1.07+ (0 => whole input file)                                     */
+    long long       lShardEnd;              /* v. 1.07+ the shard ends before a record starting at this offset      */
 
 
     /* */
@@ -50,11 +50,13 @@
 static int already_have_this_message( char *prev_messages, const char *new_message );
 
 
-/****************************************************************************/
-const char *ErrMsg( int nErrorCode )
+/****************************************************************************
+  Return error description; szErrMsg[ERR_MSG_LEN] is a caller-supplied
+  buffer used only for codes without a fixed text (v. 1.07+: no static buffer)
+****************************************************************************/
+const char *ErrMsg( int nErrorCode, char *szErrMsg )
 {
     const char *p;
-    static char szErrMsg[64];
     switch (nErrorCode)
     {
         case 0:                      p = "";                      break;
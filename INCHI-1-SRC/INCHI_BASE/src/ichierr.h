@@ -160,7 +160,8 @@ extern "C" {
 
 #define STR_ERR_LEN 256
 
-const char *ErrMsg( int nErrorCode );
+#define ERR_MSG_LEN 64
+const char *ErrMsg( int nErrorCode, char *szErrMsg );
 
 int AddErrorMessage( char *pStrErr, const char *szMsg );
 
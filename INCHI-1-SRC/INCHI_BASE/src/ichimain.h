@@ -75,8 +75,8 @@ typedef struct tagStructData
     int           nErrorType;
     int           nStructReadError;
     char          pStrErrStruct[STR_ERR_LEN];
-    long          fPtrStart;  /* or number of processed structures */
-    long          fPtrEnd;    /* or number of errors */
+    long long     fPtrStart;  /* or number of processed structures */
+    long long     fPtrEnd;    /* or number of errors */
     int           bUserQuit;
     int           bUserQuitComponent;
     int           bUserQuitComponentDisplay;
@@ -228,7 +228,16 @@ MAIN_LOOP_ACTION;
 /* GENERAL PROCESSING STEPS */
 
 
+/* Totals of processing one input file (summed up in AMI mode) */
+typedef struct tagInputFileTotals
+{
+    long          num_inp;
+    long          num_err;
+    unsigned long ulProcessingTime;
+} INPUT_FILE_TOTALS;
+
 int ProcessSingleInputFile( int argc, char *argv[] );
+int ProcessSingleInputFileEx( int argc, char *argv[], INPUT_FILE_TOTALS *totals );
 int ProcessMultipleInputFiles( int argc, char *argv[] );
 int ReadCommandLineParms( int argc, const char *argv[], INPUT_PARMS *ip,
                           char *szSdfDataValue, unsigned long *ulDisplTime,
@@ -357,6 +366,21 @@ int CalcAndPrintINCHIAndINCHIKEY( struct tagINCHI_CLOCK *ic,
                                   unsigned long *pulTotalProcessingTime,
                                   char *pLF, char *pTAB,
                                   char *ikey, int silent );
+#if ( BUILD_WITH_THREADS == 1 )
+int ProcessInputRecordsInThreads( struct tagINCHI_CLOCK *ic,
+                                  INPUT_PARMS *ip,
+                                  INCHI_IOSTREAM *inp_file,
+                                  INCHI_IOSTREAM *plog,
+                                  INCHI_IOSTREAM *pout,
+                                  INCHI_IOSTREAM *pprb,
+                                  int num_threads,
+                                  int output_error_inchi,
+                                  char *pLF, char *pTAB,
+                                  long *num_inp,
+                                  long *num_err,
+                                  unsigned long *pulTotalProcessingTime,
+                                  RUN_STAT *pRunStat );
+#endif
 int GetOneStructure( struct tagINCHI_CLOCK *ic,
                      STRUCT_DATA *sd,
                      INPUT_PARMS *ip,
@@ -586,6 +610,7 @@ void set_line_separators( int bINChIOutputOptions, char **pLF, char **pTAB );
 void save_command_line( int argc, char *argv[], INCHI_IOSTREAM *plog );
 void emit_empty_inchi( INPUT_PARMS *ip, long num_inp,
                        char *pLF, char *pTAB, INCHI_IOSTREAM *pout );
+void flush_record_stream( INCHI_IOSTREAM *ios, FILE *f2 );
 
 #ifndef COMPILE_ANSI_ONLY
 void eat_keyboard_input( void );
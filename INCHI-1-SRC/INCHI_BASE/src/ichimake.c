@@ -4424,6 +4424,7 @@ int  Create_INChI(CANON_GLOBALS* pCG,
                 pCG,
                 nMode, i);
         }
+        pCG->m_RunStat.lNumStereoMappings += pCS->lNumStereoMappings; /* v. 1.07+ */
 
         pINChI = ppINChI[i];      /* pointers to already allocated still empty InChI */
         pINChI_Aux = ppINChI_Aux[i];
@@ -137,6 +137,25 @@ int SortNeighLists3( int num_atoms,
                      NEIGH_LIST *NeighList,
                      AT_RANK *nAtomNumber );
 
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+int DifferentiateRanksQueue( CANON_GLOBALS *pCG,
+                             int num_atoms,
+                             NEIGH_LIST *NeighList,
+                             AT_RANK *pnCurrRank,
+                             AT_RANK *pnPrevRank,
+                             AT_RANK *nAtomNumber,
+                             AT_RANK nMaxAtRank,
+                             long *lNumIter );
+int DifferentiateRanksQueue2( CANON_GLOBALS *pCG,
+                              int num_atoms,
+                              NEIGH_LIST *NeighList,
+                              int nNumCurrRanks,
+                              AT_RANK *pnCurrRank,
+                              AT_RANK *pnPrevRank,
+                              AT_RANK *nAtomNumber,
+                              long *lNumIter,
+                              int bOrdAtNumb );
+#endif
 
 
 /****************************************************************************
@@ -275,7 +294,7 @@ int SetNewRanksFromNeighLists3( CANON_GLOBALS *pCG,
             continue;
         }
         r1 = r2;
-        insertions_sort_AT_NUMBERS( pCG, nAtomNumber + i, (int) r2 - i, CompNeighLists );
+        insertions_sort_AT_NUMBERS_NeighLists( nAtomNumber + i, (int) r2 - i, NeighList, nRank );
         /*insertions_sort( nAtomNumber+i, r2-i, sizeof( nAtomNumber[0] ), CompNeighLists );*/
         j = r2 - 1;
         k = (int)nAtomNumber[j];
@@ -347,8 +366,8 @@ int SetNewRanksFromNeighLists4( CANON_GLOBALS *pCG,
         */
         r1 = r2;
 
-        insertions_sort_AT_NUMBERS( pCG, nAtomNumber + i,
-            (int) r2 - i, CompNeighListsUpToMaxRank );
+        insertions_sort_AT_NUMBERS_NeighListsUpToMaxRank( nAtomNumber + i,
+            (int) r2 - i, NeighList, nRank, nMaxAtRank );
         /*insertions_sort( nAtomNumber+i, r2-i, sizeof( nAtomNumber[0] ),  CompNeighListsUpToMaxRank );*/
 
         j = r2 - 1; /* prepare cycle backward, from j to i step -1 */
@@ -530,10 +549,24 @@ int  DifferentiateRanks2( CANON_GLOBALS *pCG,
     /*  SortNeighLists2 needs sorted ranks */
     pCG->m_pn_RankForSort = pnCurrRank;
     if (bUseAltSort & 1)
-        tsort( pCG, nAtomNumber, num_atoms, sizeof( nAtomNumber[0] ), CompRank /* CompRanksOrd*/ );
+        insertions_sort_AT_NUMB_by_Rank( nAtomNumber, num_atoms, pnCurrRank );
     else
         inchi_qsort( pCG, nAtomNumber, num_atoms, sizeof( nAtomNumber[0] ), CompRanksOrd );
 
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+    if (bUseAltSort & DIFF_RANKS_QUEUE)
+    {
+        int nNumQueueRanks = DifferentiateRanksQueue2( pCG, num_atoms, NeighList, nNumCurrRanks,
+                                                       pnCurrRank, pnPrevRank, nAtomNumber, lNumIter, 1 );
+        if (nNumQueueRanks >= 0)
+        {
+            return nNumQueueRanks;
+        }
+        /* not applicable or out of RAM: fall back to full re-ranking */
+        pCG->m_pn_RankForSort = pnCurrRank;
+    }
+#endif
+
     do
     {
         *lNumIter += 1;
@@ -550,6 +583,252 @@ int  DifferentiateRanks2( CANON_GLOBALS *pCG,
 }
 
 
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+/****************************************************************************
+
+  DifferentiateQueue: change-driven equivalent of Differentiate3
+  (nMaxAtRank == 0) and Differentiate4 (ignore neighbors with rank > nMaxAtRank)
+
+  Each pass still splits the tied cells by neighbor lists ranked with
+  the ranks of the previous pass, so the resulting ranks, nAtomNumber[]
+  and neighbor list orders are identical to those of the full re-ranking.
+  However, after the first pass only the tied cells containing a neighbor
+  of an atom whose rank has just changed are re-sorted and re-ranked:
+  neighbor lists and ranks of all other cells cannot change.
+
+ Note: on entry nAtomNumber[] must be sorted according to pnCurrRank[]
+ Note2: on exit both pnCurrRank[] and pnPrevRank[] contain the final ranks
+ Note3: the work arrays are taken from the scratch arena pCG->m_Arena
+ Return value: number of different ranks or -1 if out of memory
+ ****************************************************************************/
+int DifferentiateRanksQueue( CANON_GLOBALS *pCG,
+                             int num_atoms,
+                             NEIGH_LIST *NeighList,
+                             AT_RANK *pnCurrRank,
+                             AT_RANK *pnPrevRank,
+                             AT_RANK *nAtomNumber,
+                             AT_RANK nMaxAtRank,
+                             long *lNumIter )
+{
+    AT_RANK   *nRank = pnPrevRank;   /* ranks of the previous pass */
+    AT_RANK   *nNewRank = pnCurrRank; /* ranks being created by the current pass */
+    AT_RANK   *nChanged, *nCellQueue, *bCellQueued;
+    NEIGH_LIST nl;
+    int        num_changed, num_cells, nNumNewRanks, nNumDiffRanks;
+    int        i, j, k, m, first;
+    AT_RANK    r, r2;
+    CANON_ARENA_MARK ArenaMark; /* scratch memory of this call */
+
+    CanonArenaOpen( pCG, &ArenaMark );
+    nChanged = (AT_RANK *) CanonArenaAlloc( pCG, 3 * (size_t) num_atoms + 1, sizeof( nChanged[0] ), 0 );
+    if (!nChanged)
+    {
+        CanonArenaClose( pCG, &ArenaMark );
+        return -1;
+    }
+    nCellQueue = nChanged + num_atoms;    /* ranks of the tied cells to re-rank */
+    bCellQueued = nCellQueue + num_atoms; /* bCellQueued[rank] != 0 => in nCellQueue[] */
+    memset( bCellQueued, 0, ( (long long) num_atoms + 1 ) * sizeof( bCellQueued[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    memcpy( nRank, nNewRank, num_atoms * sizeof( nRank[0] ) );
+
+    /*  set globals for insertions_sort_AT_NUMBERS */
+    pCG->m_pNeighList_RankForSort = NeighList;
+    pCG->m_pn_RankForSort = nRank;
+    if (nMaxAtRank)
+    {
+        pCG->m_nMaxAtNeighRankForSort = nMaxAtRank;
+    }
+
+    /*  the first pass re-ranks all tied cells */
+    for (i = 0, num_cells = 0; i < num_atoms; i = ( r > i ) ? (int) r : i + 1)
+    {
+        r = nRank[(int) nAtomNumber[i]];
+        if (r > i + 1)
+        {
+            nCellQueue[num_cells++] = r;
+        }
+    }
+
+    do
+    {
+        *lNumIter += 1;
+        num_changed = 0;
+        nNumNewRanks = 0;
+        for (m = 0; m < num_cells; m++)
+        {
+            /* tied rank r: nAtomNumber[first..r-1] have rank r */
+            r = nCellQueue[m];
+            bCellQueued[r] = 0;
+            for (first = (int) r - 1; first > 0 && nRank[(int) nAtomNumber[first - 1]] == r; first--)
+            {
+                ;
+            }
+            for (k = first; k < (int) r; k++)
+            {
+                i = (int) nAtomNumber[k];
+                if (NeighList[i][0] > 1)
+                {
+                    insertions_sort_NeighList_AT_NUMBERS3( NeighList[i], nRank );
+                }
+            }
+            if (nMaxAtRank)
+            {
+                insertions_sort_AT_NUMBERS_NeighListsUpToMaxRank( nAtomNumber + first, (int) r - first,
+                                                                  NeighList, nRank, nMaxAtRank );
+            }
+            else
+            {
+                insertions_sort_AT_NUMBERS_NeighLists( nAtomNumber + first, (int) r - first, NeighList, nRank );
+            }
+            /* same backward cycle as in SetNewRanksFromNeighLists3/4; only the */
+            /* atoms that get a new rank are stored                           */
+            for (j = (int) r - 1, r2 = r; j > first; )
+            {
+                if (nMaxAtRank ? CompareNeighListLexUpToMaxRank( NeighList[nAtomNumber[j - 1]],
+                                                                 NeighList[nAtomNumber[j]], nRank, nMaxAtRank )
+                               : CompareNeighListLex( NeighList[nAtomNumber[j - 1]],
+                                                      NeighList[nAtomNumber[j]], nRank ))
+                {
+                    r2 = (AT_RANK) j;
+                    nNumNewRanks++;
+                }
+                j--;
+                if (r2 != r)
+                {
+                    i = (int) nAtomNumber[j];
+                    nNewRank[i] = r2;
+                    nChanged[num_changed++] = (AT_RANK) i;
+                }
+            }
+        }
+
+        /* accept new ranks; queue tied cells adjacent to the atoms that have changed ranks */
+        for (m = 0; m < num_changed; m++)
+        {
+            i = (int) nChanged[m];
+            nRank[i] = nNewRank[i];
+        }
+        for (m = 0, num_cells = 0; m < num_changed; m++)
+        {
+            nl = NeighList[(int) nChanged[m]];
+            for (k = 1; k <= (int) nl[0]; k++)
+            {
+                r = nRank[(int) nl[k]];
+                if (!bCellQueued[r] && r > 1 && nRank[(int) nAtomNumber[r - 2]] == r)
+                {
+                    bCellQueued[r] = 1;
+                    nCellQueue[num_cells++] = r;
+                }
+            }
+        }
+    }
+    while (nNumNewRanks);
+
+    CanonArenaClose( pCG, &ArenaMark );
+
+    for (i = 0, nNumDiffRanks = 0; i < num_atoms; i++)
+    {
+        nNumDiffRanks += ( nRank[(int) nAtomNumber[i]] == i + 1 );
+    }
+
+    return nNumDiffRanks;
+}
+
+
+/****************************************************************************
+
+  DifferentiateQueue2: change-driven equivalent of Differentiate2
+  (bOrdAtNumb != 0) and DifferentiateBasic with bUseAltSort & 1
+
+  Both re-rank all atoms by CompNeighListRanks/CompNeighListRanksOrd and
+  sort all neighbor lists (SortNeighLists2) on every pass until the ranks
+  stop changing. DifferentiateQueue() makes the same passes, therefore
+  gives the same ranks and, both sorts being stable, the same nAtomNumber[]
+  as the stable CompNeighListRanks. To obtain the rest of the results
+
+  - every neighbor list is sorted by the final ranks,
+  - (bOrdAtNumb) atoms of each cell are ordered by atom number,
+  - *lNumIter and the sort globals are set as Differentiate2 leaves them;
+    DifferentiateBasic makes one more pass if the first one has not
+    changed the ranks but nNumCurrRanks on entry was different.
+
+  Used in the stereo mapping only, i.e. when the callers of Differentiate2
+  and DifferentiateBasic pass DIFF_RANKS_QUEUE in bUseAltSort.
+
+ Note: on entry nAtomNumber[] must be sorted according to pnCurrRank[]
+ Note2: the first item assumes that SortNeighLists2() sorts all neighbor
+        lists (FIX_STEREOCOUNT_ERR); otherwise -1 is returned
+ Return value: number of different ranks or -1 if out of memory
+ ****************************************************************************/
+int DifferentiateRanksQueue2( CANON_GLOBALS *pCG,
+                              int num_atoms,
+                              NEIGH_LIST *NeighList,
+                              int nNumCurrRanks,
+                              AT_RANK *pnCurrRank,
+                              AT_RANK *pnPrevRank,
+                              AT_RANK *nAtomNumber,
+                              long *lNumIter,
+                              int bOrdAtNumb )
+{
+    AT_RANK *nNextInCell = NULL;
+    long     num_passes = 0;
+    int      i, nNumDiffRanks;
+    AT_RANK  r;
+    CANON_ARENA_MARK ArenaMark; /* scratch memory of this call */
+
+#ifndef FIX_STEREOCOUNT_ERR
+    return -1;
+#endif
+    CanonArenaOpen( pCG, &ArenaMark );
+    if (bOrdAtNumb)
+    {
+        nNextInCell = (AT_RANK *) CanonArenaAlloc( pCG, (size_t) num_atoms + 1, sizeof( nNextInCell[0] ), 0 );
+        if (!nNextInCell)
+        {
+            CanonArenaClose( pCG, &ArenaMark );
+            return -1;
+        }
+    }
+    nNumDiffRanks = DifferentiateRanksQueue( pCG, num_atoms, NeighList, pnCurrRank, pnPrevRank,
+                                             nAtomNumber, 0, &num_passes );
+    if (nNumDiffRanks < 0)
+    {
+        CanonArenaClose( pCG, &ArenaMark );
+        return nNumDiffRanks;
+    }
+    for (i = 0; i < num_atoms; i++)
+    {
+        if (NeighList[i][0] > 1)
+        {
+            insertions_sort_NeighList_AT_NUMBERS3( NeighList[i], pnCurrRank );
+        }
+    }
+    if (nNextInCell)
+    {
+        /* cell having rank r starts at the position of its first atom */
+        for (i = num_atoms - 1; i >= 0; i--)
+        {
+            nNextInCell[pnCurrRank[(int) nAtomNumber[i]]] = (AT_RANK) i;
+        }
+        for (i = 0; i < num_atoms; i++)
+        {
+            r = pnCurrRank[i];
+            nAtomNumber[(int) nNextInCell[r]++] = (AT_RANK) i;
+        }
+    }
+    CanonArenaClose( pCG, &ArenaMark );
+    if (!bOrdAtNumb && num_passes == 1 && nNumDiffRanks != nNumCurrRanks)
+    {
+        num_passes++;
+    }
+    *lNumIter += num_passes;
+    pCG->m_pn_RankForSort = ( num_passes & 1 ) ? pnCurrRank : pnPrevRank;
+
+    return nNumDiffRanks;
+}
+#endif
+
+
 /****************************************************************************
   Differentiate3
 
@@ -575,6 +854,16 @@ int  DifferentiateRanks3( CANON_GLOBALS *pCG,
         }
     */
 
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+    nNumCurrRanks = DifferentiateRanksQueue( pCG, num_atoms, NeighList, pnCurrRank, pnPrevRank,
+                                             nAtomNumber, 0, lNumIter );
+    if (nNumCurrRanks >= 0)
+    {
+        return nNumCurrRanks;
+    }
+    /* out of RAM: fall back to full re-ranking */
+#endif
+
     /*  SortNeighLists3 needs sorted ranks: ranks/atnumbers must have been already sorted */
     do
     {
@@ -610,6 +899,16 @@ int  DifferentiateRanks4( CANON_GLOBALS *pCG, int num_atoms, NEIGH_LIST *NeighLi
             int stop=1;
         }
     */
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+    nNumCurrRanks = DifferentiateRanksQueue( pCG, num_atoms, NeighList, pnCurrRank, pnPrevRank,
+                                             nAtomNumber, nMaxAtRank, lNumIter );
+    if (nNumCurrRanks >= 0)
+    {
+        return nNumCurrRanks;
+    }
+    /* out of RAM: fall back to full re-ranking */
+#endif
+
     /*  SortNeighLists4 needs sorted ranks: ranks/atnumbers must have been already sorted */
     do
     {
@@ -644,7 +943,21 @@ int  DifferentiateRanksBasic( CANON_GLOBALS *pCG, int num_atoms, NEIGH_LIST *Nei
     pCG->m_pn_RankForSort = pnCurrRank;
     if (bUseAltSort & 1)
     {
-        tsort( pCG, nAtomNumber, num_atoms, sizeof( nAtomNumber[0] ), CompRank );
+        insertions_sort_AT_NUMB_by_Rank( nAtomNumber, num_atoms, pnCurrRank );
+
+#if ( BUILD_WITH_REFINE_QUEUE == 1 )
+        if (bUseAltSort & DIFF_RANKS_QUEUE)
+        {
+            nNumPrevRanks = DifferentiateRanksQueue2( pCG, num_atoms, NeighList, nNumCurrRanks,
+                                                      pnCurrRank, pnPrevRank, nAtomNumber, lNumIter, 0 );
+            if (nNumPrevRanks >= 0)
+            {
+                return nNumPrevRanks;
+            }
+            /* not applicable or out of RAM: fall back to full re-ranking */
+            pCG->m_pn_RankForSort = pnCurrRank;
+        }
+#endif
     }
     else
     {
@@ -1370,6 +1683,8 @@ int map_an_atom2( CANON_GLOBALS *pCG,
     int     i, bAtFromHasAlreadyBeenMapped, nNumTies;
     AT_RANK nNewRank;
 
+    pCS->lNumStereoMappings++;
+
     nNumTies = NumberOfTies( pRankStack1, pRankStack2, length, at_no1, at_no2, &nNewRank, bAddStack, &bAtFromHasAlreadyBeenMapped );
 
     if (RETURNED_ERROR( nNumTies ))
@@ -1397,7 +1712,7 @@ int map_an_atom2( CANON_GLOBALS *pCG,
         nNewRank2[at_no2] = nNewRank;
         nNewNumRanks2 = DifferentiateRanks2( pCG, num_atoms, NeighList,
                                          nNumMappedRanks, nNewRank2, nTempRank,
-                                         nNewAtomNumber2, &pCS->lNumNeighListIter, 1 );
+                                         nNewAtomNumber2, &pCS->lNumNeighListIter, 1 | DIFF_RANKS_QUEUE );
         pCS->lNumBreakTies++;
 
         /*  Check whether the old mapping can be reused */
@@ -1428,7 +1743,7 @@ int map_an_atom2( CANON_GLOBALS *pCG,
             nNewRank1[at_no1] = nNewRank;
             nNewNumRanks1 = DifferentiateRanks2( pCG, num_atoms, NeighList,
                                              nNumMappedRanks, nNewRank1, nTempRank,
-                                             nNewAtomNumber1, &pCS->lNumNeighListIter, 1 );
+                                             nNewAtomNumber1, &pCS->lNumNeighListIter, 1 | DIFF_RANKS_QUEUE );
             pCS->lNumBreakTies++;
         }
         else
@@ -1674,7 +1989,7 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
         pRankStack1[0][ia] = nSymmRank[ia];
         nNumDiffRanks = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                      nNumDiffRanks, pRankStack1[0], nTempRank,
-                                     pRankStack1[1], lNumIter, 1 );
+                                     pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
     }
     /*  3. In case of a double bond/cumulene only: */
     /*     fix at[ib] -- the opposite double bond/cumulene atom */
@@ -1689,7 +2004,7 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
             pRankStack1[0][ib] = nRank2;
             nNumDiffRanks = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                          nNumDiffRanks, pRankStack1[0], nTempRank,
-                                         pRankStack1[1], lNumIter, 1 );
+                                         pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
         }
     }
 
@@ -1719,12 +2034,12 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
     pRankStack1[0][n1] = nRank2;
     nNumDiffRanks1 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                  nNumDiffRanks, pRankStack1[0], nTempRank,
-                                 pRankStack1[1], lNumIter, 1 );
+                                 pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
 
     pRankStack2[0][n2] = nRank2;
     nNumDiffRanks2 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                  nNumDiffRanks, pRankStack2[0], nTempRank,
-                                 pRankStack2[1], lNumIter, 1 );
+                                 pRankStack2[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
 
     if (nNumDiffRanks1 != nNumDiffRanks2)
     {
@@ -1806,11 +2121,11 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
                     pRankStack1[0][nn1] = nRank1;
                     nNumDiffRanks1 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                                  nNumDiffRanks, pRankStack1[0], nTempRank,
-                                                 pRankStack1[1], lNumIter, 1 );
+                                                 pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
                     pRankStack2[0][nn2] = nRank2;
                     nNumDiffRanks2 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                                  nNumDiffRanks, pRankStack2[0], nTempRank,
-                                                 pRankStack2[1], lNumIter, 1 );
+                                                 pRankStack2[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
                     if (nNumDiffRanks1 != nNumDiffRanks2)
                     {
                         return -1; /*  <BRKPT> */
@@ -1902,11 +2217,11 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
                     pRankStack1[0][nn1] = nRank1;
                     nNumDiffRanks1 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                                  nNumDiffRanks, pRankStack1[0], nTempRank,
-                                                 pRankStack1[1], lNumIter, 1 );
+                                                 pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
                     pRankStack2[0][nn2] = nRank2;
                     nNumDiffRanks2 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                                  nNumDiffRanks, pRankStack2[0], nTempRank,
-                                                 pRankStack2[1], lNumIter, 1 );
+                                                 pRankStack2[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
 
                     if (nNumDiffRanks1 != nNumDiffRanks2)
                     {
@@ -1952,12 +2267,12 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
             pRankStack1[0][n2] = nRank2;
             nNumDiffRanks1 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                          nNumDiffRanks, pRankStack1[0], nTempRank,
-                                         pRankStack1[1], lNumIter, 1 );
+                                         pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
 
             pRankStack2[0][n1] = nRank2;
             nNumDiffRanks2 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                          nNumDiffRanks, pRankStack2[0], nTempRank,
-                                         pRankStack2[1], lNumIter, 1 );
+                                         pRankStack2[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
         }
     }
 
@@ -2029,12 +2344,12 @@ int BreakNeighborsTie( CANON_GLOBALS *pCG,
             pRankStack1[0][neigh1] = nRank2;
             nNumDiffRanks1 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                          nNumDiffRanks, pRankStack1[0], nTempRank,
-                                         pRankStack1[1], lNumIter, 1 );
+                                         pRankStack1[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
 
             pRankStack2[0][neigh2] = nRank2;
             nNumDiffRanks2 = DifferentiateRanksBasic( pCG, num_at_tg, NeighList,
                                          nNumDiffRanks, pRankStack2[0], nTempRank,
-                                         pRankStack2[1], lNumIter, 1 );
+                                         pRankStack2[1], lNumIter, 1 | DIFF_RANKS_QUEUE );
         }
     }
 #endif
@@ -64,6 +64,7 @@ static int deep_map_stereo_atoms4=0;
         pCS->lNumTotCT
         pCS->lNumEqualCT
         pCS->lNumDecreasedCT
+        pCS->lNumStereoMappings (map_an_atom2)
         pCS->bExtract (bRELEASE_VERSION == 0)
         pCS->ulTimeOutTime
 
@@ -67,6 +67,7 @@ int mark_alt_bonds_and_taut_groups( struct tagINCHI_CLOCK *ic,
                                     INCHI_MODE *inpbTautFlagsDone,
                                     int nebend, int *ebend );
 
+int AllocTGroupInfoTGroups( T_GROUP_INFO *t_group_info, int num_atoms );
 int MarkTautomerGroups( struct tagCANON_GLOBALS *pCG, inp_ATOM *at,
                         int num_atoms,
                         T_GROUP_INFO *t_group_info,
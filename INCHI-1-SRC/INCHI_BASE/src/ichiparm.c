@@ -1281,6 +1281,45 @@ int ReadCommandLineParms(int argc,
                 }
             }
 
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+            else if (!inchi_memicmp(pArg, "THREADS:", 8))
+            {
+                /* number of worker threads; 0 => one per CPU */
+                ip->nNumThreads = (int)strtol(pArg + 8, NULL, 10);
+                if (ip->nNumThreads <= 0)
+                {
+                    ip->nNumThreads = -1;
+                }
+            }
+            else if (!inchi_memicmp(pArg, "COMPTHREADS:", 12))
+            {
+                /* number of threads for components of one structure; 0 => one per CPU */
+                ip->nNumCompThreads = (int)strtol(pArg + 12, NULL, 10);
+                if (ip->nNumCompThreads <= 0)
+                {
+                    ip->nNumCompThreads = -1;
+                }
+            }
+#endif
+#ifdef TARGET_EXE_STANDALONE
+            else if (!inchi_stricmp(pArg, "BUILDINDEX"))
+            {
+                ip->bBuildIndex = 1;
+            }
+            else if (!inchi_memicmp(pArg, "SHARD:", 6))
+            {
+                /* byte range shard k of N, k = 0...N-1 */
+                char* q;
+                ip->nShard = (int)strtol(pArg + 6, &q, 10);
+                ip->nNumShards = (*q == '/') ? (int)strtol(q + 1, NULL, 10) : 0;
+                if (ip->nNumShards < 1 || ip->nShard < 0 || ip->nShard >= ip->nNumShards)
+                {
+                    inchi_ios_eprint(log_file, "Invalid shard \"%s\": expected Shard:k/N with 0 <= k < N\n", pArg);
+                    ip->nShard = ip->nNumShards = 0;
+                }
+            }
+#endif
+
             else if (!inchi_memicmp(pArg, "RSB:", 4) && developer_options)
             {
                 mdbr = (int)strtol(pArg + 4, NULL, 10);
@@ -2571,6 +2610,10 @@ int PrintInputParms(INCHI_IOSTREAM* log_file,
     {
         inchi_ios_eprint(log_file, "Terminate after structure #%ld\n", ip->last_struct_number);
     }
+    if (ip->nNumShards > 1)
+    {
+        inchi_ios_eprint(log_file, "Treat only byte range shard %d of %d\n", ip->nShard, ip->nNumShards);
+    }
     if (ip->bSaveWarningStructsAsProblem && ip->path[3] && ip->path[3][0])
     {
         inchi_ios_eprint(log_file, "Saving warning structures into the problem file\n");
@@ -2736,12 +2779,23 @@ void HelpCommandLineParms(INCHI_IOSTREAM* f)
     inchi_ios_print_nodisplay(f, "  START:n     Start at n-th input structure\n");
     inchi_ios_print_nodisplay(f, "  END:n       Stop after n-th input structure\n");
     inchi_ios_print_nodisplay(f, "  RECORD:n    Treat only n-th input structure\n");
+#ifdef TARGET_EXE_STANDALONE
+    inchi_ios_print_nodisplay(f, "  BuildIndex  Write index of SDfile records to inputFile.idx and exit;\n              the index lets START:n skip the preceding records\n");
+    inchi_ios_print_nodisplay(f, "  Shard:k/N   Treat only SDfile records starting in the k-th of N equal\n              byte ranges of the input file (k = 0...N-1); without the index\n              structure numbers are relative to the shard\n");
+#endif
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+    inchi_ios_print_nodisplay(f, "  Threads:n   Process input structures in n parallel threads (0: one per CPU)\n");
+    inchi_ios_print_nodisplay(f, "  CompThreads:n Process components of a structure in n parallel threads\n              (0: one per CPU); with RecMet also create the disconnected\n              and reconnected layers concurrently\n");
+#endif
 
 #if ( BUILD_WITH_AMI == 1 )
     inchi_ios_print_nodisplay(f, "  AMI         Allow multiple input files (wildcards supported)\n");
     inchi_ios_print_nodisplay(f, "  AMIOutStd   Write output to stdout (in AMI mode)\n");
     inchi_ios_print_nodisplay(f, "  AMILogStd   Write log to stderr (in AMI mode)\n");
     inchi_ios_print_nodisplay(f, "  AMIPrbNone  Suppress creation of problem files (in AMI mode)\n");
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+    inchi_ios_print_nodisplay(f, "  AMIThreads:n Process n input files in parallel (in AMI mode;\n              0: one per CPU; not with AMIOutStd or AMILogStd)\n");
+#endif
 #endif
 
 
@@ -2994,7 +3048,8 @@ int OpenFiles(FILE** inp_file,
                 *inp_file != stdin &&
                 !(ip->bINChIOutputOptions & INCHI_OUT_SDFILE_ONLY) &&
                 !ip->bNoStructLabels &&
-                !(ip->bINChIOutputOptions & INCHI_OUT_TABBED_OUTPUT))
+                !(ip->bINChIOutputOptions & INCHI_OUT_TABBED_OUTPUT) &&
+                !(ip->nNumShards > 1 && ip->nShard > 0)) /* v. 1.07+: shard outputs concatenate as one run */
             {
                 PrintFileName("* Input_File: \"%s\"\n", *out_file, ip->path[0]);
             }
@@ -3064,11 +3119,12 @@ int DetectInputINChIFileType(FILE** inp_file,
     const char* fmode)
 {
     char szLine[256], ret = 0;
-    static char szPlnVersion[NUM_VERSIONS][LEN_VERSIONS]; /* = "INChI:1.1Beta/";*/
-    static int  lenPlnVersion[NUM_VERSIONS];
-    static char szPlnAuxVer[NUM_VERSIONS][LEN_VERSIONS]; /* = "AuxInfo:1.1Beta/";*/
-    static int  lenPlnAuxVer[NUM_VERSIONS];
-    static int  bInitialized = 0;
+    /* v. 1.07+: not static; filled on each call so that the function is reentrant */
+    char szPlnVersion[NUM_VERSIONS][LEN_VERSIONS]; /* = "INChI:1.1Beta/";*/
+    int  lenPlnVersion[NUM_VERSIONS];
+    char szPlnAuxVer[NUM_VERSIONS][LEN_VERSIONS]; /* = "AuxInfo:1.1Beta/";*/
+    int  lenPlnAuxVer[NUM_VERSIONS];
+    int  bInitialized = 0;
     int  bINChI_plain = 0, len, i;
 
 
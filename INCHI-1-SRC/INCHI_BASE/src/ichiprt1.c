@@ -2463,7 +2463,7 @@ int WriteOrigAtoms( CANON_GLOBALS *pCG,
             }
             if (is_ok && b_self <= 1 && b_self + k == MAX_NUM_STEREO_ATOM_NEIGH)
             {
-                num_trans += insertions_sort( pCG, nNeighOrder, k, sizeof( nNeighOrder[0] ), comp_AT_RANK );
+                num_trans += insertions_sort_AT_RANK( nNeighOrder, k );
                 if (ATOM_PARITY_WELL_DEF( at[j].p_parity ))
                 {
                     parity = 2 - ( num_trans + at[j].p_parity ) % 2;
@@ -2633,7 +2633,7 @@ int WriteOrigBonds( CANON_GLOBALS *pCG,
                 nNeighOrder[k] = k;
             }
             pCG->m_pn_RankForSort = at[j].neighbor;
-            num_trans = insertions_sort( pCG, nNeighOrder, at[j].valence, sizeof( nNeighOrder[0] ), CompRank ); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
+            num_trans = insertions_sort_AT_NUMB_by_Rank( nNeighOrder, at[j].valence, at[j].neighbor ); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
         }
         else
         {
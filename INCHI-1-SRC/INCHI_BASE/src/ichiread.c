@@ -10573,6 +10573,20 @@ int getInChIChar(INCHI_IOSTREAM* pInp)
         }
         return RI_ERR_EOF;
     }
+    else if (pInp->type == INCHI_IOS_TYPE_MMAP)
+    {
+        /* input from memory mapped file */
+        int c;
+#if ( defined(_MSC_VER)&&defined(_WIN32) || defined(__BORLANDC__)&&defined(__WIN32__) || defined(__GNUC__)&&defined(__MINGW32__)&&defined(_WIN32) )
+        do
+        {
+            c = inchi_ios_str_getc(pInp);
+        } while (c == '\r');
+#else
+        c = inchi_ios_str_getc(pInp);
+#endif
+        return (c == EOF) ? RI_ERR_EOF : c;
+    }
     else
     {
         /* input from plain file */
@@ -38,6 +38,8 @@
  *
 */
 
+#include <string.h>
+
 #include "mode.h"
 #include "ichiring.h"
 
@@ -45,6 +47,9 @@
 
 /* Local prototypes */
 int GetMinRingSize( inp_ATOM* atom, QUEUE *q, AT_RANK *nAtomLevel, S_CHAR *cSource, AT_RANK nMaxRingSize );
+#if ( BUILD_WITH_RING_CACHE == 1 )
+static void RingCacheStore( RING_CACHE *prc, inp_ATOM* atom, int at_no, int neigh_ord, int nMinRingSize, AT_RANK nMaxRingSize );
+#endif
 
 /*  add to the queue */
 int QueueAdd( QUEUE *q, QINT_TYPE *Val );
@@ -358,6 +363,7 @@ int GetMinRingSize( inp_ATOM* atom,
      q          queue structure
      nAtomLevel work array, DFS distance
      cSource    work array, origin mark
+     prc        results of the previous calls or NULL; see RingCacheCheckBonds()
 ****************************************************************************/
 int is_bond_in_Nmax_memb_ring( inp_ATOM* atom,
                                int at_no,
@@ -365,7 +371,8 @@ int is_bond_in_Nmax_memb_ring( inp_ATOM* atom,
                                QUEUE *q,
                                AT_RANK *nAtomLevel,
                                S_CHAR *cSource,
-                               AT_RANK nMaxRingSize )
+                               AT_RANK nMaxRingSize,
+                               RING_CACHE *prc )
 {
     int  nMinRingSize = -1, i;
     qInt n;
@@ -376,6 +383,21 @@ int is_bond_in_Nmax_memb_ring( inp_ATOM* atom,
         return 0;
     }
 
+#if ( BUILD_WITH_RING_CACHE == 1 )
+    if (prc && at_no < prc->num_at && prc->nSearched[i = at_no * MAXVAL + neigh_ord])
+    {
+        if (prc->nRingSize[i])
+        {
+            /* the smallest ring containing the bond is known */
+            return ( prc->nRingSize[i] < nMaxRingSize ) ? prc->nRingSize[i] : 0;
+        }
+        if (nMaxRingSize <= prc->nSearched[i])
+        {
+            return 0; /* no ring smaller than nSearched[i] */
+        }
+    }
+#endif
+
     QueueReinit( q );
 
     /*  mark the starting atom */
@@ -412,10 +434,132 @@ int is_bond_in_Nmax_memb_ring( inp_ATOM* atom,
     QueueDelete( q );
     */
 
+#if ( BUILD_WITH_RING_CACHE == 1 )
+    if (prc && at_no < prc->num_at && nMinRingSize >= 0)
+    {
+        RingCacheStore( prc, atom, at_no, neigh_ord, nMinRingSize, nMaxRingSize );
+    }
+#endif
+
     return nMinRingSize;
 }
 
 
+#if ( BUILD_WITH_RING_CACHE == 1 )
+/****************************************************************************
+  Save is_bond_in_Nmax_memb_ring() result for both directions of the bond.
+
+  The BFS finds the smallest ring containing the bond whatever atom it
+  starts from, and a ring that is not smaller than nMaxRingSize stops it
+  before the ring is found; therefore the result tells the exact min.
+  ring size if it is positive and only that there is no ring smaller
+  than nMaxRingSize otherwise.
+****************************************************************************/
+static void RingCacheStore( RING_CACHE *prc,
+                            inp_ATOM* atom,
+                            int at_no,
+                            int neigh_ord,
+                            int nMinRingSize,
+                            AT_RANK nMaxRingSize )
+{
+    int i = at_no * MAXVAL + neigh_ord;
+    int neigh = (int) atom[at_no].neighbor[neigh_ord];
+    int j;
+
+    prc->nRingSize[i] = (AT_RANK) nMinRingSize;
+    prc->nSearched[i] = nMaxRingSize;
+    if (neigh < prc->num_at)
+    {
+        for (j = 0; j < atom[neigh].valence; j++)
+        {
+            if (atom[neigh].neighbor[j] == (AT_NUMB) at_no)
+            {
+                i = neigh * MAXVAL + j;
+                prc->nRingSize[i] = (AT_RANK) nMinRingSize;
+                prc->nSearched[i] = nMaxRingSize;
+                break;
+            }
+        }
+    }
+}
+#endif
+
+
+/****************************************************************************
+  Make the ring cache describe atom[0..num_at-1].
+
+  The saved results are kept if the bonds (valences and neighbor lists)
+  are the same as when they were obtained and discarded otherwise.
+  Call it before the bond queries whenever the bonds might have been
+  changed; on allocation failure the cache is just not used.
+****************************************************************************/
+void RingCacheCheckBonds( RING_CACHE *prc, inp_ATOM *atom, int num_at )
+{
+#if ( BUILD_WITH_RING_CACHE == 1 )
+    int      i, bChanged;
+    AT_NUMB *nBonds;
+
+    if (!prc)
+    {
+        return;
+    }
+    if (num_at > prc->max_num_at)
+    {
+        RingCacheFree( prc );
+        prc->nRingSize = (AT_RANK *) inchi_calloc( (long long) num_at * MAXVAL, sizeof( prc->nRingSize[0] ) );
+        prc->nSearched = (AT_RANK *) inchi_calloc( (long long) num_at * MAXVAL, sizeof( prc->nSearched[0] ) );
+        prc->nBonds = (AT_NUMB *) inchi_calloc( (long long) num_at * ( MAXVAL + 1 ), sizeof( prc->nBonds[0] ) );
+        if (!prc->nRingSize || !prc->nSearched || !prc->nBonds)
+        {
+            RingCacheFree( prc );
+            return;
+        }
+        prc->max_num_at = num_at;
+    }
+
+    bChanged = ( num_at != prc->num_at );
+    for (i = 0, nBonds = prc->nBonds; i < num_at; i++, nBonds += MAXVAL + 1)
+    {
+        if (!bChanged && nBonds[0] == (AT_NUMB) atom[i].valence &&
+             !memcmp( nBonds + 1, atom[i].neighbor, atom[i].valence * sizeof( nBonds[0] ) ))
+        {
+            continue;
+        }
+        bChanged = 1;
+        nBonds[0] = (AT_NUMB) atom[i].valence;
+        memcpy( nBonds + 1, atom[i].neighbor, atom[i].valence * sizeof( nBonds[0] ) );
+    }
+    if (bChanged)
+    {
+        memset( prc->nSearched, 0, (long long) num_at * MAXVAL * sizeof( prc->nSearched[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    }
+    prc->num_at = num_at;
+#endif
+}
+
+
+/****************************************************************************/
+void RingCacheFree( RING_CACHE *prc )
+{
+    if (prc)
+    {
+        if (prc->nRingSize)
+        {
+            inchi_free( prc->nRingSize );
+        }
+        if (prc->nSearched)
+        {
+            inchi_free( prc->nSearched );
+        }
+        if (prc->nBonds)
+        {
+            inchi_free( prc->nBonds );
+        }
+        memset( prc, 0, sizeof( *prc ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    }
+}
+
+
 /****************************************************************************/
 int is_atom_in_3memb_ring( inp_ATOM* atom, int at_no )
 {
@@ -63,6 +63,15 @@ typedef struct tagQieue {
 #endif
 }QUEUE;
 
+/* v. 1.07+: results of is_bond_in_Nmax_memb_ring() kept while the bonds do not change */
+typedef struct tagRingCache {
+    AT_RANK *nRingSize;  /* [num_at*MAXVAL]: min. ring size of bond atom[i]-atom[i].neighbor[j] or 0 */
+    AT_RANK *nSearched;  /* [num_at*MAXVAL]: ring sizes < nSearched have been searched; 0 => not yet */
+    AT_NUMB *nBonds;     /* [num_at*(MAXVAL+1)]: valence and neighbors the results belong to */
+    int      num_at;     /* number of atoms covered by the cache; 0 => no cache */
+    int      max_num_at; /* allocated */
+} RING_CACHE;
+
 #ifndef COMPILE_ALL_CPP
 #ifdef __cplusplus
 extern "C" {
@@ -71,7 +80,10 @@ extern "C" {
 
     QUEUE *QueueCreate( int nTotLength, int nSize );
     QUEUE *QueueDelete( QUEUE *q );
-    int is_bond_in_Nmax_memb_ring( inp_ATOM* atom, int at_no, int neigh_ord, QUEUE *q, AT_RANK *nAtomLevel, S_CHAR *cSource, AT_RANK nMaxRingSize );
+    int is_bond_in_Nmax_memb_ring( inp_ATOM* atom, int at_no, int neigh_ord, QUEUE *q, AT_RANK *nAtomLevel, S_CHAR *cSource, AT_RANK nMaxRingSize,
+                                   RING_CACHE *prc );
+    void RingCacheCheckBonds( RING_CACHE *prc, inp_ATOM *atom, int num_at );
+    void RingCacheFree( RING_CACHE *prc );
     int is_atom_in_3memb_ring( inp_ATOM* atom, int at_no );
 
 #ifndef COMPILE_ALL_CPP
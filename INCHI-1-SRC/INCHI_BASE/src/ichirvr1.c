@@ -3836,7 +3836,8 @@ int nNumEdgesToCnVertex( MY_CONST C_NODE *pCN, int len, int v )
 
 
 /*********************************************************************************
-BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct, VAL_AT *pVA,
+BN_STRUCT* AllocateAndInitTCGBnStruct( CANON_GLOBALS *pCG,
+                                       StrFromINChI *pStruct, VAL_AT *pVA,
                                        ALL_TC_GROUPS *pTCGroups,
                                        int nMaxAddAtoms, int nMaxAddEdges,
                                        int max_altp, int *pNum_changed_bonds )
@@ -3876,7 +3877,8 @@ atom vertices and bond edges:
   Here are not included nDelta(dots) from ChargeStruct and flow to ChargeStruct
 
  *********************************************************************************/
-BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct, VAL_AT *pVA,
+BN_STRUCT* AllocateAndInitTCGBnStruct( CANON_GLOBALS *pCG,
+                                       StrFromINChI *pStruct, VAL_AT *pVA,
                                        ALL_TC_GROUPS *pTCGroups,
                                        int nMaxAddAtoms, int nMaxAddEdges,
                                        int max_altp, int *pNum_changed_bonds )
@@ -3896,7 +3898,7 @@ BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct, VAL_AT *pVA,
     int i, j, k, m, n_edges, num_bonds, num_edges;
     int f1, f2, c1, c2, edge_cap, edge_flow, st_cap, st_flow, flag_alt_bond;
     int tot_st_cap, tot_st_flow;
-    int max_tg, max_edges, max_vertices, len_alt_path, max_iedges, num_iedges, num_altp;
+    int max_tg, max_edges, max_vertices, len_alt_path, max_iedges, num_iedges;
 
     /* count vertices */
     max_tg = pTCGroups->num_tgroups;
@@ -3919,33 +3921,11 @@ BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct, VAL_AT *pVA,
     len_alt_path = max_vertices + iALTP_HDR_LEN + 1; /* may overflow if an edge is traversed in 2 directions */
     len_alt_path += inchi_max( max_vertices / 2, 16 ); /* to avoid the overflow */
 
-    if (!(pBNS = (BN_STRUCT*)inchi_calloc(1, sizeof(BN_STRUCT))) ||
-        !(pBNS->edge = (BNS_EDGE*)inchi_calloc(max_edges, sizeof(BNS_EDGE))) ||
-        !(pBNS->vert = (BNS_VERTEX*)inchi_calloc(max_vertices, sizeof(BNS_VERTEX))) ||
-        !(pBNS->iedge = (BNS_IEDGE*)inchi_calloc(max_iedges, sizeof(BNS_IEDGE))))
+    if (!( pBNS = AllocateBnStructArrays( pCG, max_vertices, max_edges, max_iedges, max_altp, len_alt_path ) ))
     {
-        return DeAllocateBnStruct( pBNS );
+        return NULL;
     }
 
-    /* alt path init (standard spell) */
-    for (num_altp = 0; num_altp < max_altp && num_altp < BN_MAX_ALTP; num_altp++)
-    {
-        if (!( pBNS->altp[num_altp] = (BNS_ALT_PATH*) inchi_calloc( len_alt_path, sizeof( BNS_ALT_PATH ) ) ))
-        {
-            return DeAllocateBnStruct( pBNS );
-        }
-        ALTP_ALLOCATED_LEN( pBNS->altp[num_altp] ) = len_alt_path;
-        pBNS->len_alt_path = len_alt_path;  /* ??? duplication ??? */
-        /* re-init */
-        ALTP_DELTA( pBNS->altp[num_altp] ) = 0;
-        ALTP_START_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
-        ALTP_END_ATOM( pBNS->altp[num_altp] ) = NO_VERTEX;
-        ALTP_PATH_LEN( pBNS->altp[num_altp] ) = 0;
-    }
-    pBNS->alt_path = NULL;
-    pBNS->num_altp = 0;
-    pBNS->max_altp = num_altp;
-
 
     /* fill vertices (no connectivity) */
     iedge = pBNS->iedge;
@@ -3980,7 +3960,7 @@ BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct, VAL_AT *pVA,
     num_iedges = (int) ( iedge - pBNS->iedge );
     if (max_iedges - num_iedges < ( nMaxAddEdges + NUM_KINDS_OF_GROUPS )*max_vertices)
     {
-        return DeAllocateBnStruct( pBNS );
+        return ReleaseBnStruct( pCG, pBNS );
     }
 
     pBNS->num_atoms = num_atoms;      /* number of real atoms */
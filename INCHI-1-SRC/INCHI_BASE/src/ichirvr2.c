@@ -3920,6 +3920,7 @@ int EliminateChargeSeparationOnHeteroatoms( BN_STRUCT *pBNS,
 
     if (forbidden_stereo_edge_mask)
     {
+        RingCacheCheckBonds( pStruct->pbfsq->prc, at2, num_at );
         for (i = 0; i < num_at; i++)
         {
             for (j = 0; j < at2[i].valence; j++)
@@ -3928,7 +3929,8 @@ int EliminateChargeSeparationOnHeteroatoms( BN_STRUCT *pBNS,
                 {
                     int nMinRingSize = is_bond_in_Nmax_memb_ring( at2, i, j, pStruct->pbfsq->q,
                                                              pStruct->pbfsq->nAtomLevel,
-                                                             pStruct->pbfsq->cSource, 99 /* max ring size */ );
+                                                             pStruct->pbfsq->cSource, 99 /* max ring size */,
+                                                             pStruct->pbfsq->prc );
                     if (0 < nMinRingSize && ( ret = AddToEdgeList( &FixedLargeRingStereoEdges, k, 64 ) ))
                     {
                         goto exit_function;
@@ -319,16 +319,20 @@ exit_function:
 
 
 /****************************************************************************/
-/* djb-rwth: placed as global variables to avoid function buffer issues */
-short iat_DB_O[MAX_DIFF_FIXH], iat_SB_O_Minus[MAX_DIFF_FIXH];
-short iat_DB_O_Plus[MAX_DIFF_FIXH], iat_SB_NH[MAX_DIFF_FIXH];
-short iat_SB_N_Minus[MAX_DIFF_FIXH], iat_DB_N[MAX_DIFF_FIXH];
-short iat_SB_Neutr[MAX_DIFF_FIXH], iat_DB_Charged[MAX_DIFF_FIXH];
-short iat_DB_NHn_Plus[MAX_DIFF_FIXH], iat_SB_NHm_Neutr[MAX_DIFF_FIXH];
-short iat_DB_O_Neutr[MAX_DIFF_FIXH], iat_DB_N_Neutr[MAX_DIFF_FIXH];
-short iat_SB_N_Neutr[MAX_DIFF_FIXH], iat_N_V_Array[MAX_DIFF_FIXH];
-short iat_Central[MAX_DIFF_FIXH], iat_NO2[MAX_DIFF_FIXH];
-TgDiffHChgFH tdhc[MAX_DIFF_FIXH];
+/* djb-rwth: placed outside of the function to avoid function buffer issues */
+/* v. 1.07+: allocated per call rather than at file scope to keep the function reentrant */
+typedef struct tagFixFixedHWork
+{
+    short iat_DB_O[MAX_DIFF_FIXH], iat_SB_O_Minus[MAX_DIFF_FIXH];
+    short iat_DB_O_Plus[MAX_DIFF_FIXH], iat_SB_NH[MAX_DIFF_FIXH];
+    short iat_SB_N_Minus[MAX_DIFF_FIXH], iat_DB_N[MAX_DIFF_FIXH];
+    short iat_SB_Neutr[MAX_DIFF_FIXH], iat_DB_Charged[MAX_DIFF_FIXH];
+    short iat_DB_NHn_Plus[MAX_DIFF_FIXH], iat_SB_NHm_Neutr[MAX_DIFF_FIXH];
+    short iat_DB_O_Neutr[MAX_DIFF_FIXH], iat_DB_N_Neutr[MAX_DIFF_FIXH];
+    short iat_SB_N_Neutr[MAX_DIFF_FIXH], iat_N_V_Array[MAX_DIFF_FIXH];
+    short iat_Central[MAX_DIFF_FIXH], iat_NO2[MAX_DIFF_FIXH];
+    TgDiffHChgFH tdhc[MAX_DIFF_FIXH];
+} FIX_FIXED_H_WORK;
 
 int FixFixedHRestoredStructure( CANON_GLOBALS *pCG,
                                 INCHI_CLOCK *ic,
@@ -372,6 +376,25 @@ int FixFixedHRestoredStructure( CANON_GLOBALS *pCG,
 
     int        nNumRunBNS = 0, forbidden_edge_mask_inv = ~forbidden_edge_mask; /* djb-rwth: ignoring LLVM warning: variable used */
 
+    FIX_FIXED_H_WORK *pWork = (FIX_FIXED_H_WORK *) inchi_calloc( 1, sizeof( *pWork ) );
+    short      *iat_DB_O = pWork ? pWork->iat_DB_O : NULL;
+    short      *iat_SB_O_Minus = pWork ? pWork->iat_SB_O_Minus : NULL;
+    short      *iat_DB_O_Plus = pWork ? pWork->iat_DB_O_Plus : NULL;
+    short      *iat_SB_NH = pWork ? pWork->iat_SB_NH : NULL;
+    short      *iat_SB_N_Minus = pWork ? pWork->iat_SB_N_Minus : NULL;
+    short      *iat_DB_N = pWork ? pWork->iat_DB_N : NULL;
+    short      *iat_SB_Neutr = pWork ? pWork->iat_SB_Neutr : NULL;
+    short      *iat_DB_Charged = pWork ? pWork->iat_DB_Charged : NULL;
+    short      *iat_DB_NHn_Plus = pWork ? pWork->iat_DB_NHn_Plus : NULL;
+    short      *iat_SB_NHm_Neutr = pWork ? pWork->iat_SB_NHm_Neutr : NULL;
+    short      *iat_DB_O_Neutr = pWork ? pWork->iat_DB_O_Neutr : NULL;
+    short      *iat_DB_N_Neutr = pWork ? pWork->iat_DB_N_Neutr : NULL;
+    short      *iat_SB_N_Neutr = pWork ? pWork->iat_SB_N_Neutr : NULL;
+    short      *iat_N_V_Array = pWork ? pWork->iat_N_V_Array : NULL;
+    short      *iat_Central = pWork ? pWork->iat_Central : NULL;
+    short      *iat_NO2 = pWork ? pWork->iat_NO2 : NULL;
+    TgDiffHChgFH *tdhc = pWork ? pWork->tdhc : NULL;
+
     INCHI_HEAPCHK
 
     AllocEdgeList( &AllChargeEdges, EDGE_LIST_CLEAR );
@@ -384,6 +407,12 @@ int FixFixedHRestoredStructure( CANON_GLOBALS *pCG,
 
     tot_succes = 0;
 
+    if (!pWork)
+    {
+        ret = RI_ERR_ALLOC;
+        goto exit_function;
+    }
+
     if (!pInChI[0]->nNum_H_fixed && !pStruct->pOneINChI[0]->nNum_H_fixed)
     {
         goto exit_function;  /* no fixed-H found */
@@ -468,6 +497,7 @@ int FixFixedHRestoredStructure( CANON_GLOBALS *pCG,
     }
     if (forbidden_stereo_edge_mask)
     {
+        RingCacheCheckBonds( pStruct->pbfsq->prc, at2, pStruct->num_atoms );
         for (i = 0; i < pStruct->num_atoms; i++)
         {
             for (j = 0; j < at2[i].valence; j++)
@@ -476,7 +506,8 @@ int FixFixedHRestoredStructure( CANON_GLOBALS *pCG,
                 {
                     int nMinRingSize = is_bond_in_Nmax_memb_ring( at2, i, j, pStruct->pbfsq->q,
                                                                   pStruct->pbfsq->nAtomLevel,
-                                                                  pStruct->pbfsq->cSource, 99 /* max ring size */ );
+                                                                  pStruct->pbfsq->cSource, 99 /* max ring size */,
+                                                                  pStruct->pbfsq->prc );
                     if (0 < nMinRingSize && ( ret = AddToEdgeList( &FixedLargeRingStereoEdges, k, INC_ADD_EDGE ) ))
                     {
                         goto exit_function;
@@ -6530,6 +6561,11 @@ exit_function:
     AllocEdgeList( &FixedLargeRingStereoEdges, EDGE_LIST_FREE );
     AllocEdgeList( &AllBondEdges, EDGE_LIST_FREE );
 
+    if (pWork)
+    {
+        inchi_free( pWork );
+    }
+
     return ret < 0 ? ret : ( tot_succes && pc2i->bHasDifference );
 }
 
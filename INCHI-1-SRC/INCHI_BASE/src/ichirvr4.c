@@ -3282,6 +3282,7 @@ int RestoreAtomMakeBNS(INCHI_CLOCK* ic, CANON_GLOBALS* pCG,
     {
         goto exit_function;
     }
+    bfsq.prc = pCG ? &pCG->m_RingCache : NULL;
     pStruct->pbfsq = &bfsq;
 
     if (pStruct->iMobileH == TAUT_NON && pInChI[1] && pInChI[1]->nNumberOfAtoms > 1 &&
@@ -3291,6 +3292,7 @@ int RestoreAtomMakeBNS(INCHI_CLOCK* ic, CANON_GLOBALS* pCG,
     }
 
     /* mark metal atoms; find min ring sizes for atoms that have 2 bonds */
+    RingCacheCheckBonds(bfsq.prc, at, num_at);
     for (i = 0; i < num_at; i++)
     {
         pVA[i].cNumValenceElectrons = get_sp_element_type(at[i].el_number, &j);
@@ -3313,7 +3315,7 @@ int RestoreAtomMakeBNS(INCHI_CLOCK* ic, CANON_GLOBALS* pCG,
         if (at[i].valence == 2 && !at[i].num_H)
         {
             pVA[i].cMinRingSize = is_bond_in_Nmax_memb_ring(at, i, 0, bfsq.q, bfsq.nAtomLevel,
-                bfsq.cSource, 99 /* max ring size */);
+                bfsq.cSource, 99 /* max ring size */, bfsq.prc);
         }
         else
         {
@@ -3386,7 +3388,7 @@ repeat_for_new_metals:
     }
 
     /* create the BNS and fill it with all real atoms */
-    pBNS = AllocateAndInitTCGBnStruct(pStruct, pVA, pTCGroups,
+    pBNS = AllocateAndInitTCGBnStruct(pCG, pStruct, pVA, pTCGroups,
         nMaxAddAtoms, nMaxAddEdges, max_altp, &nNum_changed_bonds);
     if (!pBNS)
     {
@@ -3411,7 +3413,7 @@ repeat_for_new_metals:
     pBNS->ic = ic;                          /* v. 1.05 */
 
     /* allocate BNData */
-    pBD = AllocateAndInitBnData(pBNS->max_vertices + pBNS->max_vertices / 2);
+    pBD = AllocateAndInitBnData(pCG, pBNS->max_vertices + pBNS->max_vertices / 2);
     if (!pBD)
     {
         ret = BNS_OUT_OF_RAM;
@@ -3462,8 +3464,8 @@ exit_function:
     pStruct->pbfsq = NULL;
     AllocBfsQueue(&bfsq, BFS_Q_FREE, 0);
 
-    pBD = DeAllocateBnData(pBD); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
-    pBNS = DeAllocateBnStruct(pBNS); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
+    pBD = ReleaseBnData(pCG, pBD); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
+    pBNS = ReleaseBnStruct(pCG, pBNS); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
     /*
     if ( pVA ) inchi_free( pVA );
     */
@@ -3964,4 +3966,4 @@ exit_function:
     return ret < 0 ? ret : num_changed;
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -123,7 +123,8 @@ int bIsUnsatCarbonInASmallRing( inp_ATOM *at2,
             {
                 nCurRingSize = is_bond_in_Nmax_memb_ring( at2, iat, j, pbfsq->q,
                                              pbfsq->nAtomLevel,
-                                             pbfsq->cSource, (AT_RANK) nMinRingSize /* max ring size */ );
+                                             pbfsq->cSource, (AT_RANK) nMinRingSize /* max ring size */,
+                                             pbfsq->prc );
                 if (0 < nCurRingSize && nCurRingSize < nMinRingSize)
                 {
                     nMinRingSize = nCurRingSize;
@@ -255,6 +256,7 @@ int FixMobileHRestoredStructure( CANON_GLOBALS *pCG,
     }
     if (forbidden_stereo_edge_mask)
     {
+        RingCacheCheckBonds( pStruct->pbfsq->prc, at2, pStruct->num_atoms );
         for (i = 0; i < pStruct->num_atoms; i++)
         {
             for (j = 0; j < at2[i].valence; j++)
@@ -263,7 +265,8 @@ int FixMobileHRestoredStructure( CANON_GLOBALS *pCG,
                 {
                     int nMinRingSize = is_bond_in_Nmax_memb_ring( at2, i, j, pStruct->pbfsq->q,
                                                              pStruct->pbfsq->nAtomLevel,
-                                                             pStruct->pbfsq->cSource, 99 /* max ring size */ );
+                                                             pStruct->pbfsq->cSource, 99 /* max ring size */,
+                                                             pStruct->pbfsq->prc );
                     if (0 < nMinRingSize && ( ret = AddToEdgeList( &FixedLargeRingStereoEdges, k, INC_ADD_EDGE ) ))
                     {
                         goto exit_function;
@@ -1040,6 +1043,7 @@ int FixMobileHRestoredStructure( CANON_GLOBALS *pCG,
             {
                 /* try suitable atoms C */
                 /* first look for =C= in a small ring */
+                RingCacheCheckBonds( pStruct->pbfsq->prc, at2, pStruct->num_atoms );
                 for (mode = 4; !cur_success && mode <= 8; mode++)
                 {
 
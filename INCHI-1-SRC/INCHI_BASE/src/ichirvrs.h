@@ -100,6 +100,7 @@ typedef struct tagBfsQueue {
     S_CHAR  *cSource;
     int      num_at;
     AT_RANK  min_ring_size;  /* 8 => detect 7-member and smaller rings */
+    RING_CACHE *prc;         /* v. 1.07+: min. ring sizes of bonds found so far or NULL */
 } BFS_Q;
 /**************************************/
 
@@ -698,7 +699,8 @@ int AddTGroups2TCGBnStruct( BN_STRUCT *pBNS,
                             VAL_AT *pVA,
                             ALL_TC_GROUPS *pTCGroups,
                             int nMaxAddEdges );
-BN_STRUCT* AllocateAndInitTCGBnStruct( StrFromINChI *pStruct,
+BN_STRUCT* AllocateAndInitTCGBnStruct( struct tagCANON_GLOBALS *pCG,
+                                       StrFromINChI *pStruct,
                                        VAL_AT *pVA,
                                        ALL_TC_GROUPS *pTCGroups,
                                        int nMaxAddAtoms,
@@ -59,6 +59,10 @@ of 8, that means we need no more than 30 stack entries for
 32 bit platforms, and 62 for 64-bit platforms. */
 #define STKSIZ (8*sizeof(void*) - 2)
 
+#if ( BUILD_WITH_RADIX_SORT == 1 )
+#define RADIX_SORT_BUCKETS 256 /* one pass per byte of AT_INV_KEY */
+#endif
+
 
 /****************************************************************************
  inchi's qsort
@@ -349,6 +353,115 @@ int insertions_sort_AT_NUMBERS( void *pCG,
 }
 
 
+/****************************************************************************
+ Sort atom numbers by insertions in ascending order of nRank[]
+ Same as insertions_sort( ..., CompRank ) with pn_RankForSort = nRank,
+ including the returned number of transpositions
+****************************************************************************/
+int insertions_sort_AT_NUMB_by_Rank( AT_NUMB *base, int num, const AT_RANK *nRank )
+{
+    AT_NUMB *i, *j, *pk, tmp;
+    AT_RANK rj;
+    int  k, num_trans = 0;
+    for (k = 1, pk = base; k < num; k++, pk++)
+    {
+        for (j = ( i = pk ) + 1, rj = nRank[(int) ( tmp = *j )]; j > base && nRank[(int) *i] > rj; j = i, i--)
+        {
+            *j = *i;
+            num_trans++;
+        }
+        *j = tmp;
+    }
+
+    return num_trans;
+}
+
+
+/****************************************************************************
+ Sort neighbor numbers (indexes in nNeigh[]) by insertions according to
+ ranks of the neighbors. Same as insertions_sort( ..., CompNeighborsAT_NUMBER )
+ with pNeighborsForSort = nNeigh and pn_RankForSort = nRank
+****************************************************************************/
+int insertions_sort_AT_NUMB_by_NeighRank( AT_NUMB *base, int num, const AT_NUMB *nNeigh, const AT_RANK *nRank )
+{
+    AT_NUMB *i, *j, *pk, tmp;
+    AT_RANK rj;
+    int  k, num_trans = 0;
+    for (k = 1, pk = base; k < num; k++, pk++)
+    {
+        for (j = ( i = pk ) + 1, rj = nRank[(int) nNeigh[(int) ( tmp = *j )]];
+#ifdef CT_NEIGH_INCREASE
+             j > base && nRank[(int) nNeigh[(int) *i]] > rj;
+#else
+             j > base && nRank[(int) nNeigh[(int) *i]] < rj;
+#endif
+             j = i, i--)
+        {
+            *j = *i;
+            num_trans++;
+        }
+        *j = tmp;
+    }
+
+    return num_trans;
+}
+
+
+/****************************************************************************
+ Sort atom numbers by insertions according to their neighbor lists.
+ Same as insertions_sort_AT_NUMBERS( ..., CompNeighLists )
+****************************************************************************/
+int insertions_sort_AT_NUMBERS_NeighLists( AT_NUMB *base, int num,
+                                           NEIGH_LIST *NeighList,
+                                           const AT_RANK *nRank )
+{
+    AT_NUMB *i, *j, *pk, tmp;
+    int  k, num_trans = 0;
+    for (k = 1, pk = base; k < num; k++, pk++)
+    {
+        for (j = ( i = pk ) + 1, tmp = *j;
+             j > base && 0 < CompareNeighListLex( NeighList[(int) *i], NeighList[(int) tmp], nRank );
+             j = i, i--)
+        {
+            *j = *i;
+            num_trans++;
+        }
+        *j = tmp;
+    }
+
+    return num_trans;
+}
+
+
+/****************************************************************************
+ Sort atom numbers by insertions according to their neighbor lists
+ truncated at nMaxAtRank.
+ Same as insertions_sort_AT_NUMBERS( ..., CompNeighListsUpToMaxRank )
+ with nMaxAtNeighRankForSort = nMaxAtRank
+****************************************************************************/
+int insertions_sort_AT_NUMBERS_NeighListsUpToMaxRank( AT_NUMB *base, int num,
+                                                      NEIGH_LIST *NeighList,
+                                                      const AT_RANK *nRank,
+                                                      AT_RANK nMaxAtRank )
+{
+    AT_NUMB *i, *j, *pk, tmp;
+    int  k, num_trans = 0;
+    for (k = 1, pk = base; k < num; k++, pk++)
+    {
+        for (j = ( i = pk ) + 1, tmp = *j;
+             j > base && 0 < CompareNeighListLexUpToMaxRank( NeighList[(int) *i], NeighList[(int) tmp], nRank, nMaxAtRank );
+             j = i, i--)
+        {
+            *j = *i;
+            num_trans++;
+        }
+        *j = tmp;
+    }
+
+    return num_trans;
+}
+
+
 /****************************************************************************
  Sort neighbors according to ranks in ascending order
 ****************************************************************************/
@@ -546,6 +659,176 @@ int CompAtomInvariants2( const void* a1, const void* a2, void *p )
 }
 
 
+#if ( BUILD_WITH_RADIX_SORT == 1 )
+/****************************************************************************
+ Sort atom numbers by atom invariants packed into 64-bit integer keys
+
+ Each column val[0..AT_INV_BREAK1-1] and iso_sort_key is reduced to its
+ offset from the column minimum and given just enough bits to hold the
+ column range; the columns, most significant first, and the atom number
+ are concatenated into one AT_INV_KEY per atom. Sorting these keys with
+ an LSD radix sort produces the order of inchi_qsort( ...,
+ CompAtomInvariants2 ) and two atoms have equal invariants if and only
+ if their keys without the atom number are equal.
+
+ That comparison is a total order only when the isotopic tautomeric part
+ of the invariants (val[AT_INV_BREAK1...]) cannot make two atoms
+ different; this holds if one of its columns is the same for all atoms.
+
+ On exit:      nAtomNumber[i] = number of the atom in the ith position
+               nNewRank[i]    = initial rank of the atom[i], from 1 to num_atoms
+ Return value: number of different ranks,
+               0 => not applicable (isotopic tautomeric part differs or
+                    the key does not fit in 64 bits) or out of RAM
+****************************************************************************/
+int SortAtomInvariants2( int num_atoms,
+                         const ATOM_INVARIANT2 *pAtomInvariant2,
+                         AT_RANK *nNewRank,
+                         AT_RANK *nAtomNumber )
+{
+    int         cnt[RADIX_SORT_BUCKETS + 1];
+    int         nBits[AT_INV_BREAK1 + 1];
+    int         nMin[AT_INV_BREAK1];
+    AT_INV_KEY  *key, *src, *dst, *tmp;
+    AT_INV_KEY  v, nAtMask;
+    AT_ISO_SORT_KEY nMinIso, nMaxIso;
+    int         i, k, m, shift, bConst, nMinVal, nMaxVal, nAtBits, nTotalBits, nNumDiffRanks;
+    AT_RANK     nCurrentRank;
+
+    if (num_atoms < 2)
+    {
+        return 0;
+    }
+    for (m = AT_INV_BREAK1, bConst = 0; m < AT_INV_LENGTH && !bConst; m++)
+    {
+        for (i = 1; i < num_atoms && pAtomInvariant2[i].val[m] == pAtomInvariant2[0].val[m]; i++)
+        {
+            ;
+        }
+        bConst = ( i == num_atoms );
+    }
+    if (!bConst)
+    {
+        return 0;
+    }
+
+    /* bits per column: val[0..AT_INV_BREAK1-1], iso_sort_key, atom number */
+    for (v = (AT_INV_KEY) ( num_atoms - 1 ), nAtBits = 0; v; v >>= 1)
+    {
+        nAtBits++;
+    }
+    nTotalBits = nAtBits;
+    for (m = 0; m < AT_INV_BREAK1; m++)
+    {
+        nMinVal = nMaxVal = pAtomInvariant2[0].val[m];
+        for (i = 1; i < num_atoms; i++)
+        {
+            k = pAtomInvariant2[i].val[m];
+            nMinVal = inchi_min( nMinVal, k );
+            nMaxVal = inchi_max( nMaxVal, k );
+        }
+        nMin[m] = nMinVal;
+        for (v = (AT_INV_KEY) ( nMaxVal - nMinVal ), nBits[m] = 0; v; v >>= 1)
+        {
+            nBits[m]++;
+        }
+        nTotalBits += nBits[m];
+    }
+    nMinIso = nMaxIso = pAtomInvariant2[0].iso_sort_key;
+    for (i = 1; i < num_atoms; i++)
+    {
+        nMinIso = inchi_min( nMinIso, pAtomInvariant2[i].iso_sort_key );
+        nMaxIso = inchi_max( nMaxIso, pAtomInvariant2[i].iso_sort_key );
+    }
+    for (v = (AT_INV_KEY) nMaxIso - (AT_INV_KEY) nMinIso, nBits[AT_INV_BREAK1] = 0; v; v >>= 1)
+    {
+        nBits[AT_INV_BREAK1]++;
+    }
+    nTotalBits += nBits[AT_INV_BREAK1];
+    if (nTotalBits > AT_INV_KEY_BITS)
+    {
+        return 0;
+    }
+
+    key = (AT_INV_KEY *) inchi_malloc( 2 * num_atoms * sizeof( key[0] ) );
+    if (!key)
+    {
+        return 0;
+    }
+
+    /* pack the keys column by column */
+    memset( key, 0, num_atoms * sizeof( key[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    for (m = 0; m < AT_INV_BREAK1; m++)
+    {
+        if (!nBits[m])
+        {
+            continue;
+        }
+        for (i = 0; i < num_atoms; i++)
+        {
+            key[i] = ( key[i] << nBits[m] ) | (AT_INV_KEY) ( pAtomInvariant2[i].val[m] - nMin[m] );
+        }
+    }
+    if (nBits[AT_INV_BREAK1])
+    {
+        for (i = 0; i < num_atoms; i++)
+        {
+            key[i] = ( key[i] << nBits[AT_INV_BREAK1] ) | ( (AT_INV_KEY) pAtomInvariant2[i].iso_sort_key - (AT_INV_KEY) nMinIso );
+        }
+    }
+    for (i = 0; i < num_atoms; i++)
+    {
+        key[i] = ( key[i] << nAtBits ) | (AT_INV_KEY) i;
+    }
+
+    /* LSD radix sort, one byte per pass; the keys are unique */
+    src = key;
+    dst = key + num_atoms;
+    for (shift = 0; shift < nTotalBits; shift += 8)
+    {
+        memset( cnt, 0, sizeof( cnt ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        for (i = 0; i < num_atoms; i++)
+        {
+            cnt[(int) ( ( src[i] >> shift ) & ( RADIX_SORT_BUCKETS - 1 ) ) + 1]++;
+        }
+        for (k = 1; k < RADIX_SORT_BUCKETS; k++)
+        {
+            cnt[k] += cnt[k - 1];
+        }
+        for (i = 0; i < num_atoms; i++)
+        {
+            dst[cnt[(int) ( ( src[i] >> shift ) & ( RADIX_SORT_BUCKETS - 1 ) )]++] = src[i];
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    /* unpack atom numbers and rank equal invariants */
+    nAtMask = ( (AT_INV_KEY) 1 << nAtBits ) - 1;
+    for (i = 0; i < num_atoms; i++)
+    {
+        nAtomNumber[i] = (AT_RANK) ( src[i] & nAtMask );
+    }
+    nNumDiffRanks = 1;
+    nCurrentRank = (AT_RANK) num_atoms;
+    nNewRank[nAtomNumber[num_atoms - 1]] = nCurrentRank;
+    for (i = num_atoms - 1; i > 0; i--)
+    {
+        if (( src[i - 1] ^ src[i] ) > nAtMask)
+        {
+            nNumDiffRanks++;
+            nCurrentRank = (AT_RANK) i;
+        }
+        nNewRank[nAtomNumber[i - 1]] = nCurrentRank;
+    }
+    inchi_free( key );
+
+    return nNumDiffRanks;
+}
+#endif
+
+
 /**********************************************************************************/
 /*  Compare two elements lexicographically */
 int CompChemElemLex( const void *a1, const void *a2 )
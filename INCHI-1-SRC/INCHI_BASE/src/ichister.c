@@ -117,7 +117,7 @@ static int can_be_a_stereo_bond_with_isotopic_H( inp_ATOM *at, int cur_at, INCHI
 static int half_stereo_bond_action( int nParity, int bUnknown, int bIsotopic, int vABParityUnknown );
 static int set_stereo_bonds_parity( sp_ATOM *out_at, inp_ATOM *at, int at_1, inp_ATOM *at_removed_H, int num_removed_H,
                                    INCHI_MODE nMode, QUEUE *q, AT_RANK *nAtomLevel,
-                                   S_CHAR *cSource, AT_RANK min_sb_ring_size,
+                                   S_CHAR *cSource, AT_RANK min_sb_ring_size, RING_CACHE *prc,
                                    int bPointedEdgeStereo, int vABParityUnknown );
 static int can_be_a_stereo_atom_with_isotopic_H( inp_ATOM *at, int cur_at, int bPointedEdgeStereo, int bStereoAtZz );
 static int set_stereo_atom_parity( CANON_GLOBALS *pCG, sp_ATOM *out_at, inp_ATOM *at, int cur_at, inp_ATOM *at_removed_H, int num_removed_H,
@@ -3015,6 +3015,7 @@ int set_stereo_bonds_parity( sp_ATOM *out_at,
                              AT_RANK *nAtomLevel,
                              S_CHAR *cSource,
                              AT_RANK min_sb_ring_size,
+                             RING_CACHE *prc,
                              int bPointedEdgeStereo,
                              int vABParityUnknown )
 {
@@ -3406,7 +3407,7 @@ int set_stereo_bonds_parity( sp_ATOM *out_at,
         {
             /*  check min. ring size only if both double bond/cumulene */
             /*  ending atoms belong to the same ring system */
-            j = is_bond_in_Nmax_memb_ring( at, at_1, i_next_at_1, q, nAtomLevel, cSource, min_sb_ring_size );
+            j = is_bond_in_Nmax_memb_ring( at, at_1, i_next_at_1, q, nAtomLevel, cSource, min_sb_ring_size, prc );
             if (j > 0)
             {
                 continue;
@@ -4416,6 +4417,7 @@ int set_stereo_parity( CANON_GLOBALS *pCG,
     AT_RANK *nAtomLevel = NULL;
     S_CHAR  *cSource = NULL;
     AT_RANK min_sb_ring_size = 0;
+    RING_CACHE *prc = pCG ? &pCG->m_RingCache : NULL;
 
     /**********************************************************
      *
@@ -4567,6 +4569,7 @@ int set_stereo_parity( CANON_GLOBALS *pCG,
             num_3D_stereo_atoms = CT_OUT_OF_RAM;
             goto exit_function;
         }
+        RingCacheCheckBonds( prc, at, num_at );
     }
     else
     {
@@ -4588,7 +4591,7 @@ int set_stereo_parity( CANON_GLOBALS *pCG,
             is_stereo = set_stereo_bonds_parity( at_output, at, i, at + num_at,
                                                  num_removed_H, nMode,q,
                                                  nAtomLevel, cSource,
-                                                 min_sb_ring_size,
+                                                 min_sb_ring_size, prc,
                                                  bPointedEdgeStereo,
                                                  vABParityUnknown );
             if (RETURNED_ERROR( is_stereo ))
@@ -4329,6 +4329,47 @@ int MakeIsotopicHGroup( inp_ATOM *at,
           **********************************************************************************/
 
 
+/****************************************************************************
+ Initial t_group allocation, done before the first search for
+ tautomeric groups (v. 1.07+: moved out of MarkTautomerGroups())
+ Returns 0 on success, -1 if out of RAM
+****************************************************************************/
+int AllocTGroupInfoTGroups( T_GROUP_INFO *t_group_info, int num_atoms )
+{
+    if (!t_group_info->t_group && !t_group_info->max_num_t_groups)
+    {
+        INCHI_MODE bTautFlags = t_group_info->bTautFlags;       /*  save initial setting */
+        INCHI_MODE bTautFlagsDone = t_group_info->bTautFlagsDone;   /*  save previous findings, if any */
+        TNI       tni = t_group_info->tni;
+        AT_NUMB   *tGroupNumber = t_group_info->tGroupNumber;
+        T_GROUP* tgi_tgr = NULL;  /* copied from below 2024-09-01 DT */
+        int       bIgnoreIsotopic = t_group_info->bIgnoreIsotopic;
+
+        memset( t_group_info, 0, sizeof( *t_group_info ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        t_group_info->bIgnoreIsotopic = bIgnoreIsotopic; /*  restore initial setting */
+        t_group_info->bTautFlags = bTautFlags;
+        t_group_info->bTautFlagsDone = bTautFlagsDone;
+        t_group_info->tni = tni;
+        t_group_info->tGroupNumber = tGroupNumber;
+        t_group_info->max_num_t_groups = num_atoms / 2 + 1; /*  upper limit */
+        /* djb-rwth: fixing oss-fuzz issue #52978 */
+        tgi_tgr = (T_GROUP*)inchi_calloc((long long)t_group_info->max_num_t_groups + 1, sizeof(t_group_info->t_group[0]));
+        if (!tgi_tgr)
+        {
+            t_group_info->max_num_t_groups = -1;
+            t_group_info->t_group = NULL;
+            return (-1); /*  failed, out of RAM */
+        }
+        else
+        {
+            t_group_info->t_group = tgi_tgr;
+        }
+    }
+
+    return 0;
+}
+
+
           /****************************************************************************
           Mark Tautomer Groups:
           do not identify positively charged N as endpoints for now
@@ -4349,7 +4390,6 @@ int MarkTautomerGroups( CANON_GLOBALS *pCG,
     int  nNumEndPoints, nNumBondPos, nNumPossibleMobile;
     int  bNonTautBond, bAltBond; /* djb-rwth: removing redundant variables */
     int  nNumDonor, nNumAcceptor, bPossiblyEndpoint;
-    int bIgnoreIsotopic; /* djb-rwth: removing redundant variables */
     ENDPOINT_INFO eif1, eif2;
     int nErr = 0;
 
@@ -4364,34 +4404,9 @@ int MarkTautomerGroups( CANON_GLOBALS *pCG,
     }
 
     /*  Initial t_group allocation */
-    if (!t_group_info->t_group && !t_group_info->max_num_t_groups)
+    if (AllocTGroupInfoTGroups( t_group_info, num_atoms ) < 0)
     {
-        INCHI_MODE bTautFlags = t_group_info->bTautFlags;       /*  save initial setting */
-        INCHI_MODE bTautFlagsDone = t_group_info->bTautFlagsDone;   /*  save previous findings, if any */
-        TNI       tni = t_group_info->tni;
-        AT_NUMB   *tGroupNumber = t_group_info->tGroupNumber;
-        T_GROUP* tgi_tgr = NULL;  /* copied from below 2024-09-01 DT */
-
-        bIgnoreIsotopic = t_group_info->bIgnoreIsotopic;
-        memset( t_group_info, 0, sizeof( *t_group_info ) ); /* djb-rwth: memset_s C11/Annex K variant? */
-        t_group_info->bIgnoreIsotopic = bIgnoreIsotopic; /*  restore initial setting */
-        t_group_info->bTautFlags = bTautFlags;
-        t_group_info->bTautFlagsDone = bTautFlagsDone;
-        t_group_info->tni = tni;
-        t_group_info->tGroupNumber = tGroupNumber;
-        t_group_info->max_num_t_groups = num_atoms / 2 + 1; /*  upper limit */
-        /* djb-rwth: fixing oss-fuzz issue #52978 */
-        tgi_tgr = (T_GROUP*)inchi_calloc((long long)t_group_info->max_num_t_groups + 1, sizeof(t_group_info->t_group[0]));
-        if (!tgi_tgr)
-        {
-            t_group_info->max_num_t_groups = -1;
-            t_group_info->t_group = NULL;
-            return (-1); /*  failed, out of RAM */
-        }
-        else
-        {
-            t_group_info->t_group = tgi_tgr;
-        }
+        return (-1); /*  failed, out of RAM */
     }
 
     /*  Check if t_group_info exists */
@@ -0,0 +1,253 @@
+/*
+ * International Chemical Identifier (InChI)
+ * Version 1
+ * Software version 1.07
+ * April 30, 2024
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 IUPAC and InChI Trust
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*
+* The InChI library and programs are free software developed under the
+ * auspices of the International Union of Pure and Applied Chemistry (IUPAC).
+ * Originally developed at NIST.
+ * Modifications and additions by IUPAC and the InChI Trust.
+ * Some portions of code were developed/changed by external contributors
+ * (either contractor or volunteer) which are listed in the file
+ * 'External-contributors' included in this distribution.
+ *
+ * info@inchi-trust.org
+ *
+*/
+
+
+
+#include <stdlib.h>
+
+#include "mode.h"
+#include "ichithrd.h"
+
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+#include <process.h>
+#elif ( BUILD_WITH_THREADS == 1 )
+#include <unistd.h>
+#endif
+
+
+#if ( BUILD_WITH_THREADS == 1 )
+
+typedef struct tagInchiThreadStart
+{
+    INCHI_THREAD_FUNC func;
+    void *arg;
+} INCHI_THREAD_START;
+
+
+/****************************************************************************
+ Thread entry point: unpack and call the user supplied function
+****************************************************************************/
+#if defined(_WIN32)
+static unsigned __stdcall inchi_thread_start( void *p )
+#else
+static void *inchi_thread_start( void *p )
+#endif
+{
+    INCHI_THREAD_START ts = *(INCHI_THREAD_START *) p;
+
+    free( p );
+    ts.func( ts.arg );
+
+    return 0;
+}
+#endif
+
+
+/****************************************************************************
+ Start a new thread running func( arg )
+****************************************************************************/
+int inchi_thread_create( INCHI_THREAD *t, INCHI_THREAD_FUNC func, void *arg )
+{
+#if ( BUILD_WITH_THREADS == 1 )
+    INCHI_THREAD_START *ts = (INCHI_THREAD_START *) malloc( sizeof( *ts ) );
+    if (!ts)
+    {
+        return -1;
+    }
+    ts->func = func;
+    ts->arg = arg;
+#if defined(_WIN32)
+    *t = (HANDLE) _beginthreadex( NULL, 0, inchi_thread_start, ts, 0, NULL );
+    if (*t)
+    {
+        return 0;
+    }
+#else
+    if (!pthread_create( t, NULL, inchi_thread_start, ts ))
+    {
+        return 0;
+    }
+#endif
+    free( ts );
+#endif
+
+    return -1;
+}
+
+
+/****************************************************************************
+ Wait for the thread to terminate
+****************************************************************************/
+int inchi_thread_join( INCHI_THREAD *t )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    if (WAIT_OBJECT_0 != WaitForSingleObject( *t, INFINITE ))
+    {
+        return -1;
+    }
+    CloseHandle( *t );
+    return 0;
+#elif ( BUILD_WITH_THREADS == 1 )
+    return pthread_join( *t, NULL ) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+
+/****************************************************************************/
+int inchi_mutex_init( INCHI_MUTEX *m )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    InitializeCriticalSection( m );
+    return 0;
+#elif ( BUILD_WITH_THREADS == 1 )
+    return pthread_mutex_init( m, NULL ) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_mutex_lock( INCHI_MUTEX *m )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    EnterCriticalSection( m );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_mutex_lock( m );
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_mutex_unlock( INCHI_MUTEX *m )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    LeaveCriticalSection( m );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_mutex_unlock( m );
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_mutex_destroy( INCHI_MUTEX *m )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    DeleteCriticalSection( m );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_mutex_destroy( m );
+#endif
+}
+
+
+/****************************************************************************/
+int inchi_cond_init( INCHI_COND *c )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    InitializeConditionVariable( c );
+    return 0;
+#elif ( BUILD_WITH_THREADS == 1 )
+    return pthread_cond_init( c, NULL ) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_cond_wait( INCHI_COND *c, INCHI_MUTEX *m )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    SleepConditionVariableCS( c, m, INFINITE );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_cond_wait( c, m );
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_cond_signal( INCHI_COND *c )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    WakeConditionVariable( c );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_cond_signal( c );
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_cond_broadcast( INCHI_COND *c )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    WakeAllConditionVariable( c );
+#elif ( BUILD_WITH_THREADS == 1 )
+    pthread_cond_broadcast( c );
+#endif
+}
+
+
+/****************************************************************************/
+void inchi_cond_destroy( INCHI_COND *c )
+{
+#if ( BUILD_WITH_THREADS == 1 ) && !defined(_WIN32)
+    pthread_cond_destroy( c );
+#endif
+}
+
+
+/****************************************************************************
+ Number of online processors (at least 1)
+****************************************************************************/
+int inchi_num_cpus( void )
+{
+    int n = 1;
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo( &si );
+    n = (int) si.dwNumberOfProcessors;
+#elif ( BUILD_WITH_THREADS == 1 ) && defined(_SC_NPROCESSORS_ONLN)
+    n = (int) sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+
+    return n > 0 ? n : 1;
+}
@@ -0,0 +1,114 @@
+/*
+ * International Chemical Identifier (InChI)
+ * Version 1
+ * Software version 1.07
+ * April 30, 2024
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 IUPAC and InChI Trust
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*
+* The InChI library and programs are free software developed under the
+ * auspices of the International Union of Pure and Applied Chemistry (IUPAC).
+ * Originally developed at NIST.
+ * Modifications and additions by IUPAC and the InChI Trust.
+ * Some portions of code were developed/changed by external contributors
+ * (either contractor or volunteer) which are listed in the file
+ * 'External-contributors' included in this distribution.
+ *
+ * info@inchi-trust.org
+ *
+*/
+
+
+
+#ifndef __ICHITHRD_H__
+#define __ICHITHRD_H__
+
+#include "mode.h"
+
+/*
+    Minimal portable threading layer (Win32 threads or POSIX threads)
+    used to distribute independent work items over several cores.
+    Only available if BUILD_WITH_THREADS == 1; otherwise all calls fail
+    (return non-zero) and the callers are expected to fall back to
+    serial processing.
+*/
+
+#if ( BUILD_WITH_THREADS == 1 )
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+#ifndef COMPILE_ALL_CPP
+#ifdef __cplusplus
+extern "C" {
+#endif
+#endif
+
+
+#if ( BUILD_WITH_THREADS == 1 ) && defined(_WIN32)
+    typedef HANDLE              INCHI_THREAD;
+    typedef CRITICAL_SECTION    INCHI_MUTEX;
+    typedef CONDITION_VARIABLE  INCHI_COND;
+#elif ( BUILD_WITH_THREADS == 1 )
+    typedef pthread_t           INCHI_THREAD;
+    typedef pthread_mutex_t     INCHI_MUTEX;
+    typedef pthread_cond_t      INCHI_COND;
+#else
+    typedef int                 INCHI_THREAD;
+    typedef int                 INCHI_MUTEX;
+    typedef int                 INCHI_COND;
+#endif
+
+    typedef void ( *INCHI_THREAD_FUNC )( void *arg );
+
+    /* All functions returning int return 0 on success */
+    int  inchi_thread_create( INCHI_THREAD *t, INCHI_THREAD_FUNC func, void *arg );
+    int  inchi_thread_join( INCHI_THREAD *t );
+
+    int  inchi_mutex_init( INCHI_MUTEX *m );
+    void inchi_mutex_lock( INCHI_MUTEX *m );
+    void inchi_mutex_unlock( INCHI_MUTEX *m );
+    void inchi_mutex_destroy( INCHI_MUTEX *m );
+
+    int  inchi_cond_init( INCHI_COND *c );
+    void inchi_cond_wait( INCHI_COND *c, INCHI_MUTEX *m );
+    void inchi_cond_signal( INCHI_COND *c );
+    void inchi_cond_broadcast( INCHI_COND *c );
+    void inchi_cond_destroy( INCHI_COND *c );
+
+    int  inchi_num_cpus( void );
+
+#ifndef COMPILE_ALL_CPP
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+
+#endif /* __ICHITHRD_H__ */
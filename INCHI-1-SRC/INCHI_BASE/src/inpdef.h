@@ -670,7 +670,7 @@ typedef COMP_ATOM_DATA COMP_ATOM_DATA3[TAUT_NUM+1];
 
 #define ADD_LEN_STRUCT_FPTRS 100 /* allocation increments                                  */
 
-typedef long INCHI_FPTR;
+typedef long long INCHI_FPTR; /* v. 1.07+: 64-bit file positions */
 
 /**
  * @brief Structure describing file pointers for structures
@@ -126,6 +126,62 @@ BUILD_WITH_ENG_OPTIONS
 BUILD_WITH_AMI
     Turns on AMI (Allow Multiple Inputs) mode for standalone executable
 
+BUILD_WITH_THREADS
+    Enables multi-threaded processing (options Threads:N, CompThreads:N
+    and AMIThreads:N of standalone executable); requires Win32 threads
+    or POSIX threads (link -lpthread)
+
+BUILD_WITH_MMAP
+    Read Molfile/SDfile input of standalone executable from a memory
+    mapped input file (POSIX mmap or Win32 file mapping)
+
+BUILD_WITH_REFINE_QUEUE
+    Refine ranks in canonicalization (DifferentiateRanks3/4) and in stereo
+    mapping (DifferentiateRanks2/Basic) by re-ranking
+    only the tied cells adjacent to atoms whose ranks have just changed
+    rather than re-sorting all neighbor lists on each pass; the results
+    are identical
+
+BUILD_WITH_CANON_ARENA
+    Carve the temporary arrays of each CanonGraph() call from a scratch
+    memory block kept per thread (in CANON_GLOBALS) and grown to the
+    high-water mark instead of allocating and freeing them every time
+
+BUILD_WITH_BNS_POOL
+    Keep the arrays of the balanced network structures (BN_STRUCT and
+    BN_DATA) used in normalization and structure restoration per thread
+    (in CANON_GLOBALS) and reuse them for the next component or record
+
+BUILD_WITH_BNS_PRESCREEN
+    Skip the balanced network search in normalization
+    (mark_alt_bonds_and_taut_groups) for components made of neutral
+    non-radical C and H atoms without conjugated or alternating bonds:
+    they can have neither alternating bonds nor tautomeric, salt or
+    charge groups, so the search cannot change them; the results are
+    identical
+
+BUILD_WITH_BNS_WARM_START
+    Start each balanced network search from the list of vertices whose
+    st-edges have residual capacity instead of scanning all vertices:
+    the list is made once per RunBalancedNetworkSearch() call and kept
+    up to date after each augmenting path; in the bond tests of
+    BnsTestAndMarkAltBonds() it is made only of the vertices that had
+    residual capacity before the tests and those changed by the tested
+    bond; the results are identical
+
+BUILD_WITH_RING_CACHE
+    Keep the results of the min. ring size search for a bond
+    (is_bond_in_Nmax_memb_ring) per thread (in CANON_GLOBALS) and answer
+    repeated queries for the same bond from either end from them; they
+    are discarded when the bonds change; shared by stereo perception and
+    structure restoration; the results are identical
+
+BUILD_WITH_RADIX_SORT
+    Rank atoms by their initial invariants (SetInitialRanks2) packed into
+    one 64-bit integer key per atom and sorted with an LSD radix sort
+    instead of inchi_qsort() for structures with at least 16 atoms when
+    the comparison is a total order; the results are identical
+
     Select and uncomment whichever are necessary from the list below. */
 
 
@@ -149,6 +205,57 @@ BUILD_WITH_AMI
 #endif
 #endif
 
+#ifndef BUILD_WITH_THREADS
+/* this allows BUILD_WITH_THREADS be #defined in a makefile */
+#define BUILD_WITH_THREADS 1
+#endif
+
+#ifndef BUILD_WITH_MMAP
+/* this allows BUILD_WITH_MMAP be #defined in a makefile */
+#define BUILD_WITH_MMAP 1
+#endif
+/* NB:  only stand-alone executable reads input files */
+#ifndef TARGET_EXE_STANDALONE
+#ifdef BUILD_WITH_MMAP
+#undef BUILD_WITH_MMAP
+#endif
+#endif
+
+#ifndef BUILD_WITH_REFINE_QUEUE
+/* this allows BUILD_WITH_REFINE_QUEUE be #defined in a makefile */
+#define BUILD_WITH_REFINE_QUEUE 1
+#endif
+
+#ifndef BUILD_WITH_CANON_ARENA
+/* this allows BUILD_WITH_CANON_ARENA be #defined in a makefile */
+#define BUILD_WITH_CANON_ARENA 1
+#endif
+
+#ifndef BUILD_WITH_BNS_POOL
+/* this allows BUILD_WITH_BNS_POOL be #defined in a makefile */
+#define BUILD_WITH_BNS_POOL 1
+#endif
+
+#ifndef BUILD_WITH_BNS_PRESCREEN
+/* this allows BUILD_WITH_BNS_PRESCREEN be #defined in a makefile */
+#define BUILD_WITH_BNS_PRESCREEN 1
+#endif
+
+#ifndef BUILD_WITH_BNS_WARM_START
+/* this allows BUILD_WITH_BNS_WARM_START be #defined in a makefile */
+#define BUILD_WITH_BNS_WARM_START 1
+#endif
+
+#ifndef BUILD_WITH_RING_CACHE
+/* this allows BUILD_WITH_RING_CACHE be #defined in a makefile */
+#define BUILD_WITH_RING_CACHE 1
+#endif
+
+#ifndef BUILD_WITH_RADIX_SORT
+/* this allows BUILD_WITH_RADIX_SORT be #defined in a makefile */
+#define BUILD_WITH_RADIX_SORT 1
+#endif
+
 /* Smarter AMI for Windows */
 /* Thanks, DT (2013-12-18) */
 #if( BUILD_WITH_AMI == 1 )
@@ -786,6 +893,7 @@ extern "C" {
 
 #define USE_AUX_RANKING        1 /* 1=> get auxiliary ranking to accelerate canonicalization of H layers */
 #define USE_AUX_RANKING_ALL    1 /* 1=> include all vertices in CellGetMinNode() selection 0=> only vertices with highest ranks */
+#define REUSE_NO_TAUT_H_PARTITION 1 /* 1=> skip fixed-H canonicalization when fixed H do not split NoTautH equivalence classes; v. 1.07+ */
 
 #define USE_ISO_SORT_KEY_HFIXED  0  /* 0=> normal mode: merge isotopic taut H to isotopic atom sorting key in
                                            taut H-fixed canonicalization;
@@ -1044,12 +1152,14 @@ extern "C" {
 #define INCHI_IOS_TYPE_NONE 0
 #define INCHI_IOS_TYPE_STRING 1
 #define INCHI_IOS_TYPE_FILE 2
+#define INCHI_IOS_TYPE_MMAP 3   /* v. 1.07+ memory mapped input file */
 
     typedef struct tagOutputStream
     {
         INCHI_IOS_STRING s;     /* output is directed either to resizable string buffer s   */
         FILE             *f;    /* or to the plain file:                                    */
         int              type;  /* dependent on type                                        */
+        struct tagInchiIosMmap *m; /* mapped input file (INCHI_IOS_TYPE_MMAP only)     */
     } INCHI_IOSTREAM;
 
 
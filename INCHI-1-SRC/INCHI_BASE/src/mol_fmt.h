@@ -820,14 +820,14 @@ int MolfileHasNoChemStruc(MOL_FMT_DATA *mfdata);
  * @param inp_file Pointer to the input file stream.
  * @param fPtrStart File pointer position to start copying from.
  * @param fPtrEnd File pointer position to stop copying at.
- * @param outfile Pointer to the output file stream.
+ * @param out_file Pointer to the output stream (string buffer or file).
  * @param num Structure number to write in the header line.
  * @return last position of the output file stream.
  */
 int MolfileSaveCopy(INCHI_IOSTREAM *inp_file,
-                    long fPtrStart,
-                    long fPtrEnd,
-                    FILE *outfile,
+                    long long fPtrStart,
+                    long long fPtrEnd,
+                    INCHI_IOSTREAM *out_file,
                     long num);
 
 /**
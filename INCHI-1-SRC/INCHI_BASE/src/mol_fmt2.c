@@ -381,19 +381,20 @@ int MolfileHasNoChemStruc(MOL_FMT_DATA *mfdata)
 
 /****************************************************************************
  Copy MOL-formatted data of SDF record or Molfile to another file
+ (or to string buffer of output stream, to be flushed later)
 ****************************************************************************/
 int MolfileSaveCopy(INCHI_IOSTREAM *inp_file,
-                    long fPtrStart,
-                    long fPtrEnd,
-                    FILE *outfile,
+                    long long fPtrStart,
+                    long long fPtrEnd,
+                    INCHI_IOSTREAM *out_file,
                     long num)
 {
     char line[MOL_FMT_INPLINELEN], *p;
-    long fPtr;
+    long long fPtr;
     int ret = 1;
     char szNumber[32];
 
-    if (inp_file->type == INCHI_IOS_TYPE_FILE)
+    if (inp_file->type == INCHI_IOS_TYPE_FILE || inp_file->type == INCHI_IOS_TYPE_MMAP)
     {
 
         FILE *infile = inp_file->f;
@@ -403,7 +404,7 @@ int MolfileSaveCopy(INCHI_IOSTREAM *inp_file,
             return 1;
         }
 
-        if (!outfile)
+        if (!out_file || !out_file->f)
         {
             return 1;
         }
@@ -413,12 +414,12 @@ int MolfileSaveCopy(INCHI_IOSTREAM *inp_file,
             return 1;
         }
 
-        if (0 != fseek(infile, fPtrStart, SEEK_SET))
+        if (0 != inchi_ios_seek(inp_file, fPtrStart))
         {
             return 1;
         }
 
-        while (fPtrEnd > (fPtr = ftell(infile)) && fPtr >= 0L
+        while (fPtrEnd > (fPtr = inchi_ios_tell(inp_file)) && fPtr >= 0L
                 && inchi_fgetsLf(line, sizeof(line) - 1, inp_file))
         {
 
@@ -440,10 +441,17 @@ int MolfileSaveCopy(INCHI_IOSTREAM *inp_file,
                 p[1] = '\0';
             }
 
-            fputs(line, outfile);
+            if (out_file->type == INCHI_IOS_TYPE_STRING)
+            {
+                inchi_ios_print(out_file, "%s", line);
+            }
+            else
+            {
+                fputs(line, out_file->f);
+            }
         }
 
-        ret = fseek(infile, fPtrEnd, SEEK_SET);
+        ret = inchi_ios_seek(inp_file, fPtrEnd);
     }
     else if (inp_file->type == INCHI_IOS_TYPE_STRING)
     {
@@ -545,7 +545,6 @@ char *LoadLine( INCHI_IOSTREAM *inp_file,
 
 
 /****************************************************************************/
-char szLine_i2i[INCHI_LINE_LEN]; /* djb-rwth: placed as a global variable to avoid function buffer issues */
 int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
                      MOL_COORD **szCoord,
                      int bDoNotAddH,
@@ -575,20 +574,19 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
     static const char szIsoH[] = "hdt";
     /* plain tags */
     static const char sStructHdrPln[] = "Structure:";
-    static char sStructHdrPlnAuxStart[64] = ""; /*"$1.1Beta/";*/
-    static int  lenStructHdrPlnAuxStart = 0;
+    static const char sStructHdrPlnAuxStart[] = "AuxInfo="; /*"$1.1Beta/";*/
+    const int   lenStructHdrPlnAuxStart = sizeof( sStructHdrPlnAuxStart ) - 1;
     static const char sStructHdrPlnRevAt[] = "/rA:";
     static const char sStructHdrPlnRevBn[] = "/rB:";
     static const char sStructHdrPlnRevXYZ[] = "/rC:";
     const  char *sToken;
     int  lToken, len, hlen;
     
-    ReadINCHI_CtlData ir;
+    /* djb-rwth: not placed on the stack to avoid function buffer issues; */
+    /* v. 1.07+: allocated per call rather than a global for reentrancy    */
+    char *szLine_i2i = NULL;
 
-    if (!lenStructHdrPlnAuxStart)
-    {
-        lenStructHdrPlnAuxStart = sprintf(sStructHdrPlnAuxStart, "AuxInfo=");
-    }
+    ReadINCHI_CtlData ir;
 
     if (at)
     {
@@ -610,6 +608,13 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
     {
         return num_atoms;
     }
+
+    szLine_i2i = (char *) inchi_malloc( INCHI_LINE_LEN );
+    if (!szLine_i2i)
+    {
+        *err = INCHI_INP_FATAL_ERR;
+        return INCHI_INP_FATAL_RET;
+    }
             
 
     /*
@@ -617,7 +622,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
     */
 
     ir.bHeaderRead = 0; /* djb-rwth: removing redundant code */
-    while (0 < (res = inchi_ios_getsTab(szLine_i2i, sizeof(szLine_i2i) - 1, inp_file, &ir.bTooLongLine)))
+    while (0 < (res = inchi_ios_getsTab(szLine_i2i, INCHI_LINE_LEN - 1, inp_file, &ir.bTooLongLine)))
     {
 
         if (!ir.bTooLongLine &&
@@ -679,7 +684,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
             /* Search for sToken in the line; load next segments of the line if sToken has not found */
 
             p = FindToken(inp_file, &ir.bTooLongLine, sToken, lToken,
-                szLine_i2i, sizeof(szLine_i2i), p, &res);
+                szLine_i2i, INCHI_LINE_LEN, p, &res);
 
             if (!p)
             {
@@ -698,7 +703,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
                 {
 
                     p = LoadLine(inp_file, &ir.bTooLongLine, &bItemIsOver, &s,
-                        szLine_i2i, sizeof(szLine_i2i), INCHI_LINE_ADD, p, &res);
+                        szLine_i2i, INCHI_LINE_LEN, INCHI_LINE_ADD, p, &res);
 
                     if (!i)
                     {
@@ -899,7 +904,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
             lToken = sizeof(sStructHdrPlnRevBn) - 1;
 
             /* Search for sToken in the line; load next segments of the line if sToken has not found */
-            p = FindToken(inp_file, &ir.bTooLongLine, sToken, lToken, szLine_i2i, sizeof(szLine_i2i), p, &res);
+            p = FindToken(inp_file, &ir.bTooLongLine, sToken, lToken, szLine_i2i, INCHI_LINE_LEN, p, &res);
 
             if (!p)
             {
@@ -923,14 +928,14 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
                     /* needed because the next '/' may be still out of szLine */
 
                     p = LoadLine(inp_file, &ir.bTooLongLine, &bItemIsOver, &s,
-                        szLine_i2i, sizeof(szLine_i2i), INCHI_LINE_ADD, p, &res);
+                        szLine_i2i, INCHI_LINE_LEN, INCHI_LINE_ADD, p, &res);
                 }
 
                 while (i < num_atoms)
                 {
 
                     p = LoadLine(inp_file, &ir.bTooLongLine, &bItemIsOver, &s,
-                        szLine_i2i, sizeof(szLine_i2i), INCHI_LINE_ADD, p, &res);
+                        szLine_i2i, INCHI_LINE_LEN, INCHI_LINE_ADD, p, &res);
 
                     if (i >= num_atoms || (s && p >= s)) /* djb-rwth: addressing LLVM warning */
                     {
@@ -1158,7 +1163,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
             lToken = sizeof(sStructHdrPlnRevXYZ) - 1;
 
             /* search for sToken in the line; load next segments of the line if sToken has not found */
-            p = FindToken(inp_file, &ir.bTooLongLine, sToken, lToken, szLine_i2i, sizeof(szLine_i2i), p, &res);
+            p = FindToken(inp_file, &ir.bTooLongLine, sToken, lToken, szLine_i2i, INCHI_LINE_LEN, p, &res);
 
             if (!p)
             {
@@ -1190,7 +1195,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
                 {
 
                     p = LoadLine(inp_file, &ir.bTooLongLine, &bItemIsOver, &s,
-                        szLine_i2i, sizeof(szLine_i2i), INCHI_LINE_ADD, p, &res);
+                        szLine_i2i, INCHI_LINE_LEN, INCHI_LINE_ADD, p, &res);
 
                     if (i >= num_atoms || (s && p >= s)) /* djb-rwth: addressing LLVM warning */
                     {
@@ -1685,6 +1690,7 @@ int InchiToInpAtom( INCHI_IOSTREAM *inp_file,
         FreeInchi_Stereo0D(&atom_stereo0D);
     if (res <= 0)
     {
+        inchi_free( szLine_i2i );
         if (*err == INCHI_INP_ERROR_ERR)
         {
             return num_atoms;
@@ -1715,11 +1721,13 @@ bypass_end_of_INChI_plain:
     }
 
     while (ir.bTooLongLine &&
-        0 < inchi_ios_getsTab1(szLine_i2i, sizeof(szLine_i2i) - 1, inp_file, &ir.bTooLongLine))
+        0 < inchi_ios_getsTab1(szLine_i2i, INCHI_LINE_LEN - 1, inp_file, &ir.bTooLongLine))
     {
         ;
     }
 
+    inchi_free( szLine_i2i );
+
     return num_atoms;
 
 #undef AT_NUM_BONDS
@@ -74,6 +74,7 @@
 #include "ichirvrs.h"
 
 #include "bcf_s.h"
+#include "ichithrd.h"
 
 extern int DisplayTheWholeStructure( struct tagCANON_GLOBALS *pCG,
                                      struct tagINCHI_CLOCK   *ic,
@@ -187,6 +188,31 @@ static int set_renumbered_or_delete( int *number,
 
 static void swap_atoms_xyz( ORIG_ATOM_DATA *orig_at_data, int ia1, int ia2 );
 
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+static int CreateLayersINChIInThreads( CANON_GLOBALS    *pCG,
+                                       INCHI_CLOCK      *ic,
+                                       STRUCT_DATA      *sd,
+                                       INPUT_PARMS      *ip,
+                                       char             *szTitle,
+                                       PINChI2          *pINChI2[INCHI_NUM],
+                                       PINChI_Aux2      *pINChI_Aux2[INCHI_NUM],
+                                       INCHI_IOSTREAM   *inp_file,
+                                       INCHI_IOSTREAM   *log_file,
+                                       INCHI_IOSTREAM   *out_file,
+                                       INCHI_IOSTREAM   *prb_file,
+                                       ORIG_ATOM_DATA   *orig_inp_data,
+                                       ORIG_ATOM_DATA   *prep_inp_data,
+                                       COMP_ATOM_DATA   composite_norm_data[][TAUT_NUM + 1],
+                                       long             num_inp,
+                                       INCHI_IOS_STRING *strbuf,
+                                       NORM_CANON_FLAGS *pncFlags,
+                                       int              *pnRet,
+                                       int              *pbRecDone );
+static int IsReconnectedComponentAmbiguous( INPUT_PARMS    *ip,
+                                            PINChI2        *pINChI2[INCHI_NUM],
+                                            ORIG_ATOM_DATA *prep_inp_data );
+#endif
+
 /* Callbacks */
 
 /*  Console user issued CTRL+C etc. */
@@ -235,7 +261,8 @@ int ProcessOneStructure( INCHI_CLOCK            *ic,
     int nRet = 0,
         nRet1, i, k,
         maxINChI = 0,
-        bSortPrintINChIFlags = 0;
+        bSortPrintINChIFlags = 0,
+        bLayersDone = 0, bRecDone = 0;
     COMP_ATOM_DATA
         composite_norm_data[INCHI_NUM][TAUT_NUM + 1];    /*    [0]:non-taut,
                                                         [1]:taut,
@@ -333,12 +360,29 @@ int ProcessOneStructure( INCHI_CLOCK            *ic,
 
     if (nRet != _IS_FATAL && nRet != _IS_ERROR)
     {
-        nRet1 = CreateOneStructureINChI( pCG, ic, sd, ip, szTitle,
-                                         pINChI, pINChI_Aux, INCHI_BAS,
-                                         inp_file, log_file, out_file, prb_file,
-                                         orig_inp_data, prep_inp_data,
-                                         composite_norm_data,
-                                         num_inp, strbuf, pncFlags );
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+        /* Create disconnected and reconnected layers concurrently if requested */
+        if (ip->nNumCompThreads && ip->nNumCompThreads != 1 && !ip->bDisplay && !is_polymer &&
+            ( ip->bTautFlags & TG_FLAG_RECONNECT_COORD ))
+        {
+            bLayersDone = !CreateLayersINChIInThreads( pCG, ic, sd, ip, szTitle,
+                                                       pINChI, pINChI_Aux,
+                                                       inp_file, log_file, out_file, prb_file,
+                                                       orig_inp_data, prep_inp_data,
+                                                       composite_norm_data,
+                                                       num_inp, strbuf, pncFlags,
+                                                       &nRet1, &bRecDone );
+        }
+        if (!bLayersDone)
+#endif
+        {
+            nRet1 = CreateOneStructureINChI( pCG, ic, sd, ip, szTitle,
+                                             pINChI, pINChI_Aux, INCHI_BAS,
+                                             inp_file, log_file, out_file, prb_file,
+                                             orig_inp_data, prep_inp_data,
+                                             composite_norm_data,
+                                             num_inp, strbuf, pncFlags );
+        }
         nRet = inchi_max( nRet, nRet1 );
 
         /* If we create InChI from polymer-containing structure */
@@ -372,7 +416,7 @@ int ProcessOneStructure( INCHI_CLOCK            *ic,
 
     if (nRet != _IS_FATAL && nRet != _IS_ERROR)
     {
-        maxINChI = 1;
+        maxINChI = bRecDone ? 2 : 1;
     }
 
 
@@ -380,6 +424,7 @@ int ProcessOneStructure( INCHI_CLOCK            *ic,
 
     if (nRet != _IS_FATAL                                              &&
          nRet != _IS_ERROR &&
+         !bLayersDone &&
          ( sd->bTautFlagsDone[INCHI_BAS] & TG_FLAG_DISCONNECT_COORD_DONE ) &&
          ( ip->bTautFlags & TG_FLAG_RECONNECT_COORD ))
     {
@@ -796,13 +841,752 @@ void SaveOkProcessedMolfile( int            nRet,
          0L <= sd->fPtrStart              &&
          sd->fPtrStart < sd->fPtrEnd)
     {
-        MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file->f, 0 ); /* djb-rwth: addressing coverity ID #499510 -- return values handled properly */
+        MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file, 0 ); /* djb-rwth: addressing coverity ID #499510 -- return values handled properly */
     }
 
     return;
 }
 
 
+#ifndef TARGET_LIB_FOR_WINCHI  /* { */
+#if ( bREUSE_INCHI == 1 )
+/****************************************************************************
+ Reconnected layer: find whether i-th component INChI has already been
+ calculated in basic (disconnected) layer; if so, share it.
+ Returns the number of matching basic layer components.
+****************************************************************************/
+static int ReuseDisconnectedComponentINChI( STRUCT_DATA     *sd,
+                                            PINChI2         *pINChI2[INCHI_NUM],
+                                            PINChI_Aux2     *pINChI_Aux2[INCHI_NUM],
+                                            ORIG_ATOM_DATA  *prep_inp_data,
+                                            int             iINChI,
+                                            int             i )
+{
+    PINChI2     *pINChI = pINChI2[iINChI];
+    PINChI_Aux2 *pINChI_Aux = pINChI_Aux2[iINChI];
+    int m = iINChI - 1;
+    int j, k, n;
+
+    /* Find whether we have already calculated this INChI in basic (disconnected) layer */
+    for (j = n = 0; j < prep_inp_data[m].num_components; j++)
+    {
+        if (i + 1 == prep_inp_data[m].nOldCompNumber[j] &&
+            ( pINChI2[m][j][TAUT_NON] || pINChI2[m][j][TAUT_YES] ))
+        {
+            /* Yes, we have already done this */
+            if (!n++)
+            {
+                memcpy(pINChI + i, pINChI2[m] + j, sizeof(pINChI[0]));
+                memcpy(pINChI_Aux + i, pINChI_Aux2[m] + j, sizeof(pINChI_Aux[0]));
+                for (k = 0; k < TAUT_NUM; k++)
+                {
+                    if (pINChI[i][k])
+                    {
+                        pINChI[i][k]->nRefCount++;
+                        if (pINChI[i][k]->nNumberOfAtoms > 0)
+                        {
+                            switch (k)
+                            {
+                                case TAUT_NON:
+                                    sd->num_non_taut[iINChI] ++;
+                                    break;
+                                case TAUT_YES:
+                                    if (pINChI[i][k]->lenTautomer > 0)
+                                    {
+                                        sd->num_taut[iINChI] ++;
+                                    }
+                                    else
+                                        if (!pINChI[i][TAUT_NON] ||
+                                             !pINChI[i][TAUT_NON]->nNumberOfAtoms)
+                                        {
+                                            sd->num_non_taut[iINChI] ++;
+                                        }
+                                    break;
+                            }
+                        }
+                    }
+                    if (pINChI_Aux[i][k])
+                    {
+                        pINChI_Aux[i][k]->nRefCount++;
+                    }
+                }
+            }
+        }
+    }
+
+    return n;
+}
+#endif
+#endif /* } TARGET_LIB_FOR_WINCHI */
+
+
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+
+/****************************************************************************
+ Multi-threaded processing of the components of one structure
+ (option CompThreads:n)
+
+ The components are extracted in the calling thread, then canonicalized
+ concurrently; each task owns copies of INPUT_PARMS (timeout countdown)
+ and STRUCT_DATA (errors, counters, time) as well as its own atom data.
+ The results are merged in the component order, so that errors, warnings
+ and counters are the same as in the serial main cycle.
+****************************************************************************/
+typedef struct tagComponentTask
+{
+    int              i;                  /* component number */
+    int              nRet;
+    INPUT_PARMS      ip;
+    STRUCT_DATA      sd;
+    NORM_CANON_FLAGS ncFlags;
+    INP_ATOM_DATA    InpCurAtData;
+    INP_ATOM_DATA    InpNormAtData[TAUT_NUM];
+} COMPONENT_TASK;
+
+typedef struct tagComponentPool
+{
+    INCHI_MUTEX      mutex;
+    INCHI_CLOCK      *ic;
+    ORIG_ATOM_DATA   *orig_inp_data;
+    PINChI2          *pINChI;
+    PINChI_Aux2      *pINChI_Aux;
+    int              iINChI;
+    long             num_inp;
+    INCHI_IOSTREAM   *log_file;
+    COMPONENT_TASK   **task;             /* largest components first */
+    int              num_tasks;
+    int              next_task;
+    RUN_STAT         *pRunStat;          /* of the calling thread */
+} COMPONENT_POOL;
+
+
+/****************************************************************************/
+static int CompareComponentTaskSize( const void *a1, const void *a2 )
+{
+    const COMPONENT_TASK *t1 = *(const COMPONENT_TASK **) a1;
+    const COMPONENT_TASK *t2 = *(const COMPONENT_TASK **) a2;
+    int diff = t2->InpCurAtData.num_at - t1->InpCurAtData.num_at;
+
+    return diff ? diff : ( t1->i - t2->i );
+}
+
+
+/****************************************************************************/
+static void ComponentPoolWorker( void *arg )
+{
+    COMPONENT_POOL *pool = (COMPONENT_POOL *) arg;
+    COMPONENT_TASK *t;
+    CANON_GLOBALS  CG;
+    INCHI_CLOCK    ic = *pool->ic;
+    INP_ATOM_DATA  *inp_norm_data[TAUT_NUM];
+
+    memset( &CG, 0, sizeof( CG ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+
+    for (;;)
+    {
+        inchi_mutex_lock( &pool->mutex );
+        t = pool->next_task < pool->num_tasks ? pool->task[pool->next_task++] : NULL;
+        inchi_mutex_unlock( &pool->mutex );
+        if (!t)
+        {
+            break;
+        }
+
+        inp_norm_data[TAUT_NON] = t->InpNormAtData + TAUT_NON;
+        inp_norm_data[TAUT_YES] = t->InpNormAtData + TAUT_YES;
+        t->nRet = CreateOneComponentINChI( &CG, &ic, &t->sd, &t->ip,
+                                           &t->InpCurAtData, pool->orig_inp_data,
+                                           pool->pINChI, pool->pINChI_Aux,
+                                           pool->iINChI, t->i, pool->num_inp,
+                                           inp_norm_data, &t->ncFlags, pool->log_file );
+    }
+
+    inchi_mutex_lock( &pool->mutex );
+    RunStatAddCG( pool->pRunStat, &CG );
+    inchi_mutex_unlock( &pool->mutex );
+    CanonArenaFree( &CG );
+    BnsPoolFree( &CG );
+    RingCacheFree( &CG.m_RingCache );
+}
+
+
+/****************************************************************************
+ Add the messages collected by a component task, one by one
+****************************************************************************/
+static void MergeComponentErrorMessages( char *pStrErr, const char *pStrTaskErr )
+{
+    char szMsg[STR_ERR_LEN];
+    const char *p, *q;
+    int  len;
+
+    for (p = pStrTaskErr; *p; p = q)
+    {
+        if (( q = strstr( p, "; " ) ))
+        {
+            len = (int) ( q - p );
+            q += 2;
+        }
+        else
+        {
+            len = (int) strlen( p );
+            q = p + len;
+            if (len >= 3 && !strcmp( p + len - 3, "..." ))
+            {
+                len -= 3; /* no-room marker */
+            }
+        }
+        memcpy( szMsg, p, len );
+        szMsg[len] = '\0';
+        AddErrorMessage( pStrErr, szMsg );
+    }
+}
+
+
+/****************************************************************************
+ Returns 0 if the components have been processed (*pnRet is the main
+ cycle result, *pbGotoExit requests exit without composite data), or -1
+ if the caller should process the components in the serial main cycle.
+****************************************************************************/
+static int CreateComponentsINChIInThreads( CANON_GLOBALS    *pCG,
+                                           INCHI_CLOCK      *ic,
+                                           STRUCT_DATA      *sd,
+                                           INPUT_PARMS      *ip,
+                                           PINChI2          *pINChI2[INCHI_NUM],
+                                           PINChI_Aux2      *pINChI_Aux2[INCHI_NUM],
+                                           int              iINChI,
+                                           INCHI_IOSTREAM   *inp_file,
+                                           INCHI_IOSTREAM   *log_file,
+                                           INCHI_IOSTREAM   *out_file,
+                                           INCHI_IOSTREAM   *prb_file,
+                                           ORIG_ATOM_DATA   *prep_inp_data,
+                                           INP_ATOM_DATA2   *all_inp_norm_data,
+                                           long             num_inp,
+                                           NORM_CANON_FLAGS *pncFlags,
+                                           int              *pnRet,
+                                           int              *pbGotoExit )
+{
+    ORIG_ATOM_DATA *cur_prep_inp_data = prep_inp_data + iINChI;
+    int            num_components = cur_prep_inp_data->num_components;
+    PINChI2        *pINChI = pINChI2[iINChI];
+    PINChI_Aux2    *pINChI_Aux = pINChI_Aux2[iINChI];
+    COMPONENT_TASK *tasks = NULL, **order = NULL, *t;
+    COMPONENT_POOL pool;
+    INCHI_THREAD   *threads = NULL;
+    int            num_tasks = 0, num_threads, num_started = 0;
+    int            i, j, k, n, nRet = 0, bStopped = 0;
+    int            iStop = num_components, bCannotDistinguish = 0;
+    long           lElapsedTime, lLeftTime0;
+    inchiTime      ulTStart;
+
+    num_threads = ip->nNumCompThreads > 0 ? ip->nNumCompThreads : inchi_num_cpus( );
+    if (num_threads < 2 ||
+        !( tasks = (COMPONENT_TASK *) inchi_calloc( num_components, sizeof( tasks[0] ) ) ) ||
+        !( order = (COMPONENT_TASK **) inchi_calloc( num_components, sizeof( order[0] ) ) ))
+    {
+        inchi_free( tasks );
+        return -1;
+    }
+
+    /* Extract the components in the main thread; stop where the main cycle would stop */
+    for (i = 0; i < num_components; i++)
+    {
+#if ( bREUSE_INCHI == 1 )
+        if (iINChI == INCHI_REC && !( ip->bCompareComponents & CMP_COMPONENTS ))
+        {
+            n = ReuseDisconnectedComponentINChI( sd, pINChI2, pINChI_Aux2, prep_inp_data, iINChI, i );
+            if (n == 1)
+            {
+                continue;
+            }
+            if (n > 1)
+            {
+                bCannotDistinguish = 1;
+                iStop = i;
+                break;
+            }
+        }
+#endif
+        t = tasks + num_tasks;
+        InchiTimeGet( &ulTStart );
+        CreateInpAtomData( &t->InpCurAtData, cur_prep_inp_data->nCurAtLen[i], 0 );
+        t->InpCurAtData.num_at = ExtractConnectedComponent( cur_prep_inp_data->at,
+                                                            cur_prep_inp_data->num_inp_atoms,
+                                                            i + 1, t->InpCurAtData.at );
+        if (t->InpCurAtData.num_at <= 0 || cur_prep_inp_data->nCurAtLen[i] != t->InpCurAtData.num_at)
+        {
+            /* GetOneComponent() will report the error after the preceding components */
+            FreeInpAtomData( &t->InpCurAtData );
+            iStop = i;
+            break;
+        }
+        lElapsedTime = InchiTimeElapsed( ic, &ulTStart );
+        sd->ulStructTime += lElapsedTime;
+        if (ip->msec_MaxTime)
+        {
+            ip->msec_LeftTime -= lElapsedTime;
+        }
+        t->i = i;
+        order[num_tasks++] = t;
+    }
+
+    /* Each task starts with the main cycle state except for the results it contributes; */
+    /* NB: each component gets the time left for the whole structure                    */
+    lLeftTime0 = ip->msec_LeftTime;
+    for (j = 0; j < num_tasks; j++)
+    {
+        t = tasks + j;
+        t->ip = *ip;
+        t->sd = *sd;
+        t->sd.pStrErrStruct[0] = '\0';
+        t->sd.ulStructTime = 0;
+        t->sd.num_taut[iINChI] = 0;
+        t->sd.num_non_taut[iINChI] = 0;
+    }
+
+    /* Canonicalize */
+    qsort( order, num_tasks, sizeof( order[0] ), CompareComponentTaskSize );
+    memset( &pool, 0, sizeof( pool ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    pool.ic = ic;
+    pool.orig_inp_data = cur_prep_inp_data;
+    pool.pINChI = pINChI;
+    pool.pINChI_Aux = pINChI_Aux;
+    pool.iINChI = iINChI;
+    pool.num_inp = num_inp;
+    pool.log_file = log_file;
+    pool.task = order;
+    pool.num_tasks = num_tasks;
+    pool.pRunStat = &pCG->m_RunStat;
+    num_threads = inchi_min( num_threads, num_tasks ) - 1; /* the calling thread works, too */
+    if (num_threads > 0 && !inchi_mutex_init( &pool.mutex ))
+    {
+        threads = (INCHI_THREAD *) inchi_calloc( num_threads, sizeof( threads[0] ) );
+        for (j = 0; threads && j < num_threads; j++)
+        {
+            if (inchi_thread_create( threads + num_started, ComponentPoolWorker, &pool ))
+            {
+                break;
+            }
+            num_started++;
+        }
+        ComponentPoolWorker( &pool );
+        for (j = 0; j < num_started; j++)
+        {
+            inchi_thread_join( threads + j );
+        }
+        inchi_free( threads );
+        inchi_mutex_destroy( &pool.mutex );
+    }
+    else
+    {
+        for (j = 0; j < num_tasks; j++)
+        {
+            INP_ATOM_DATA *inp_norm_data[TAUT_NUM];
+            t = order[j];
+            inp_norm_data[TAUT_NON] = t->InpNormAtData + TAUT_NON;
+            inp_norm_data[TAUT_YES] = t->InpNormAtData + TAUT_YES;
+            t->nRet = CreateOneComponentINChI( pCG, ic, &t->sd, &t->ip,
+                                               &t->InpCurAtData, cur_prep_inp_data,
+                                               pINChI, pINChI_Aux, iINChI, t->i, num_inp,
+                                               inp_norm_data, &t->ncFlags, log_file );
+        }
+    }
+
+    /* Merge the results in the order of components */
+    for (j = 0; j < num_tasks; j++)
+    {
+        t = tasks + j;
+        if (bStopped)
+        {
+            /* the main cycle would have stopped before this component */
+            for (k = 0; k < TAUT_NUM; k++)
+            {
+                Free_INChI( &pINChI[t->i][k] );
+                Free_INChI_Aux( &pINChI_Aux[t->i][k] );
+            }
+            continue;
+        }
+        sd->ulStructTime += t->sd.ulStructTime;
+        if (ip->msec_MaxTime)
+        {
+            ip->msec_LeftTime -= lLeftTime0 - t->ip.msec_LeftTime;
+        }
+        sd->num_taut[iINChI] += t->sd.num_taut[iINChI];
+        sd->num_non_taut[iINChI] += t->sd.num_non_taut[iINChI];
+#if ( bRELEASE_VERSION == 0 )
+        sd->bExtract |= t->sd.bExtract;
+#endif
+        for (k = 0; k < TAUT_NUM; k++)
+        {
+            pncFlags->bNormalizationFlags[iINChI][k] |= t->ncFlags.bNormalizationFlags[iINChI][k];
+            pncFlags->bTautFlags[iINChI][k] |= t->ncFlags.bTautFlags[iINChI][k];
+            pncFlags->bTautFlagsDone[iINChI][k] |= t->ncFlags.bTautFlagsDone[iINChI][k];
+            pncFlags->nCanonFlags[iINChI][k] |= t->ncFlags.nCanonFlags[iINChI][k];
+        }
+        MergeComponentErrorMessages( sd->pStrErrStruct, t->sd.pStrErrStruct );
+
+        if (all_inp_norm_data && !t->nRet)
+        {
+            /* Save normalized components for composite display */
+            for (k = 0; k < TAUT_NUM; k++)
+            {
+                if (t->InpNormAtData[k].bExists)
+                {
+                    all_inp_norm_data[t->i][k] = t->InpNormAtData[k];
+                    memset( t->InpNormAtData + k, 0, sizeof( t->InpNormAtData[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+                }
+            }
+        }
+
+        if (t->nRet)
+        {
+            sd->nErrorCode = t->sd.nErrorCode;
+            nRet = TreatErrorsInCreateOneComponentINChI( sd, ip,
+                                                         cur_prep_inp_data,
+                                                         t->i, num_inp, inp_file,
+                                                         log_file, out_file, prb_file );
+            bStopped = 1;
+            iStop = num_components; /* do not report later errors */
+        }
+    }
+
+    for (j = 0; j < num_tasks; j++)
+    {
+        FreeInpAtomData( &tasks[j].InpCurAtData );
+        for (k = 0; k < TAUT_NUM; k++)
+        {
+            FreeInpAtomData( tasks[j].InpNormAtData + k );
+        }
+    }
+    inchi_free( order );
+    inchi_free( tasks );
+
+    *pbGotoExit = 0;
+    if (iStop < num_components)
+    {
+        if (bCannotDistinguish)
+        {
+            /* ith component is equivalent to more than one another component */
+            AddErrorMessage( sd->pStrErrStruct, "Cannot distinguish components" );
+            sd->nStructReadError = 99;
+            sd->nErrorType = _IS_ERROR;
+            *pbGotoExit = 1;
+        }
+        else
+        {
+            INP_ATOM_DATA InpCurAtData;
+            memset( &InpCurAtData, 0, sizeof( InpCurAtData ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+            nRet = GetOneComponent( ic, sd, ip, log_file, out_file,
+                                    &InpCurAtData, cur_prep_inp_data, iStop, num_inp );
+            FreeInpAtomData( &InpCurAtData );
+        }
+    }
+
+    *pnRet = nRet;
+
+    return 0;
+}
+
+
+/****************************************************************************
+ Concurrent creation of the disconnected (INCHI_BAS) and reconnected
+ (INCHI_REC) layers (option CompThreads:n, RecMet)
+
+ The structure is preprocessed once; then the reconnected layer is made in
+ a helper thread on its own copies of INPUT_PARMS, STRUCT_DATA and the
+ flags while the calling thread makes the disconnected one. The helper
+ does not reuse the disconnected components INChI (they are not ready
+ yet) and recalculates them instead. If the reconnected layer has failed
+ or has written anything to its log, its results are discarded and it is
+ recalculated in the serial way, so the output is always the same.
+****************************************************************************/
+typedef struct tagLayerTask
+{
+    int              nRet;
+    INCHI_CLOCK      ic;
+    INPUT_PARMS      ip;
+    STRUCT_DATA      sd;
+    NORM_CANON_FLAGS ncFlags;
+    RUN_STAT         RunStat;
+    PINChI2          *pINChI2[INCHI_NUM];
+    PINChI_Aux2      *pINChI_Aux2[INCHI_NUM];
+    INCHI_IOSTREAM   *inp_file;
+    INCHI_IOSTREAM   log_file;
+    INCHI_IOSTREAM   out_file;
+    INCHI_IOSTREAM   prb_file;
+    ORIG_ATOM_DATA   *orig_inp_data;
+    ORIG_ATOM_DATA   *prep_inp_data;
+    COMP_ATOM_DATA   ( *composite_norm_data )[TAUT_NUM + 1];
+    long             num_inp;
+} LAYER_TASK;
+
+
+/****************************************************************************/
+static void ReconnectedLayerWorker( void *arg )
+{
+    LAYER_TASK    *t = (LAYER_TASK *) arg;
+    CANON_GLOBALS CG;
+
+    memset( &CG, 0, sizeof( CG ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+
+    /* szTitle and strbuf are not used without display */
+    t->nRet = CreateOneStructureINChI( &CG, &t->ic, &t->sd, &t->ip, NULL,
+                                       t->pINChI2, t->pINChI_Aux2, INCHI_REC,
+                                       t->inp_file, &t->log_file, &t->out_file, &t->prb_file,
+                                       t->orig_inp_data, t->prep_inp_data,
+                                       t->composite_norm_data,
+                                       t->num_inp, NULL, &t->ncFlags );
+    RunStatAddCG( &t->RunStat, &CG );
+    CanonArenaFree( &CG );
+    BnsPoolFree( &CG );
+    RingCacheFree( &CG.m_RingCache );
+}
+
+
+/****************************************************************************
+ Check whether a component of the reconnected layer created concurrently
+ matches more than one component of the disconnected layer; in the serial
+ order ReuseDisconnectedComponentINChI() reports such a structure as
+ "Cannot distinguish components"
+****************************************************************************/
+static int IsReconnectedComponentAmbiguous( INPUT_PARMS    *ip,
+                                            PINChI2        *pINChI2[INCHI_NUM],
+                                            ORIG_ATOM_DATA *prep_inp_data )
+{
+#if ( bREUSE_INCHI == 1 )
+    ORIG_ATOM_DATA *bas = prep_inp_data + INCHI_BAS;
+    int i, j, n;
+
+    if (( ip->bCompareComponents & CMP_COMPONENTS ) || !bas->nOldCompNumber || !pINChI2[INCHI_BAS])
+    {
+        return 0;
+    }
+    for (i = 0; i < prep_inp_data[INCHI_REC].num_components; i++)
+    {
+        for (j = n = 0; j < bas->num_components; j++)
+        {
+            n += ( i + 1 == bas->nOldCompNumber[j] &&
+                   ( pINChI2[INCHI_BAS][j][TAUT_NON] || pINChI2[INCHI_BAS][j][TAUT_YES] ) );
+        }
+        if (n > 1)
+        {
+            return 1;
+        }
+    }
+#endif
+
+    return 0;
+}
+
+
+/****************************************************************************
+ Returns 0 if both layers have been processed (*pnRet is the result,
+ *pbRecDone is set if the reconnected layer has been created), or -1
+ if the caller should create the layers one after another.
+****************************************************************************/
+static int CreateLayersINChIInThreads( CANON_GLOBALS    *pCG,
+                                       INCHI_CLOCK      *ic,
+                                       STRUCT_DATA      *sd,
+                                       INPUT_PARMS      *ip,
+                                       char             *szTitle,
+                                       PINChI2          *pINChI2[INCHI_NUM],
+                                       PINChI_Aux2      *pINChI_Aux2[INCHI_NUM],
+                                       INCHI_IOSTREAM   *inp_file,
+                                       INCHI_IOSTREAM   *log_file,
+                                       INCHI_IOSTREAM   *out_file,
+                                       INCHI_IOSTREAM   *prb_file,
+                                       ORIG_ATOM_DATA   *orig_inp_data,
+                                       ORIG_ATOM_DATA   *prep_inp_data,
+                                       COMP_ATOM_DATA   composite_norm_data[][TAUT_NUM + 1],
+                                       long             num_inp,
+                                       INCHI_IOS_STRING *strbuf,
+                                       NORM_CANON_FLAGS *pncFlags,
+                                       int              *pnRet,
+                                       int              *pbRecDone )
+{
+    LAYER_TASK   *t = NULL;
+    INCHI_THREAD thread;
+    STRUCT_DATA  *sd0 = NULL;
+    int          nRet, nRet1, k, bStarted = 0, bRecOk;
+    int          num_bas_components;
+
+    if (!orig_inp_data->at || orig_inp_data->num_inp_atoms <= 0 ||
+        ( prep_inp_data->at && prep_inp_data->num_inp_atoms ))
+    {
+        return -1;
+    }
+
+    *pbRecDone = 0;
+
+    /* Preprocess as CreateOneStructureINChI() does on its first call */
+    PreprocessOneStructure( ic, sd, ip, orig_inp_data, prep_inp_data );
+
+    pncFlags->bTautFlags[INCHI_BAS][TAUT_YES] =
+        pncFlags->bTautFlags[INCHI_BAS][TAUT_NON] =
+            sd->bTautFlags[INCHI_BAS] | ip->bTautFlags;
+
+    pncFlags->bTautFlagsDone[INCHI_BAS][TAUT_YES] =
+        pncFlags->bTautFlagsDone[INCHI_BAS][TAUT_NON] =
+            sd->bTautFlagsDone[INCHI_BAS] | ip->bTautFlagsDone;
+
+    switch (sd->nErrorType)
+    {
+        case _IS_ERROR:
+        case _IS_FATAL:
+            *pnRet = TreatErrorsInReadTheStructure( sd, ip,
+                                                    LOG_MASK_ALL,
+                                                    inp_file, log_file, out_file, prb_file,
+                                                    prep_inp_data, &num_inp );
+            return 0;
+    }
+
+    num_bas_components = prep_inp_data[INCHI_BAS].num_components;
+    if (( sd->bTautFlagsDone[INCHI_BAS] & TG_FLAG_DISCONNECT_COORD_DONE ) &&
+        ( t = (LAYER_TASK *) inchi_calloc( 1, sizeof( *t ) ) ) &&
+        ( sd0 = (STRUCT_DATA *) inchi_malloc( sizeof( *sd0 ) ) ) &&
+        ( t->pINChI2[INCHI_BAS] = (PINChI2 *) inchi_calloc( num_bas_components + 1, sizeof( PINChI2 ) ) ) &&
+        ( t->pINChI_Aux2[INCHI_BAS] = (PINChI_Aux2 *) inchi_calloc( num_bas_components + 1, sizeof( PINChI_Aux2 ) ) ))
+    {
+        /* Empty disconnected layer: nothing to reuse */
+        *sd0 = *sd;
+        t->ic = *ic;
+        t->ip = *ip;
+        t->sd = *sd;
+        t->ncFlags = *pncFlags;
+        t->pINChI2[INCHI_REC] = pINChI2[INCHI_REC];
+        t->pINChI_Aux2[INCHI_REC] = pINChI_Aux2[INCHI_REC];
+        t->inp_file = inp_file;
+        inchi_ios_init( &t->log_file, INCHI_IOS_TYPE_STRING, NULL );
+        inchi_ios_init( &t->out_file, INCHI_IOS_TYPE_STRING, NULL );
+        inchi_ios_init( &t->prb_file, INCHI_IOS_TYPE_STRING, NULL );
+        t->orig_inp_data = orig_inp_data;
+        t->prep_inp_data = prep_inp_data;
+        t->composite_norm_data = composite_norm_data;
+        t->num_inp = num_inp;
+        bStarted = !inchi_thread_create( &thread, ReconnectedLayerWorker, t );
+    }
+
+    nRet = CreateOneStructureINChI( pCG, ic, sd, ip, szTitle,
+                                    pINChI2, pINChI_Aux2, INCHI_BAS,
+                                    inp_file, log_file, out_file, prb_file,
+                                    orig_inp_data, prep_inp_data,
+                                    composite_norm_data,
+                                    num_inp, strbuf, pncFlags );
+
+    if (bStarted)
+    {
+        inchi_thread_join( &thread );
+        RunStatAdd( &pCG->m_RunStat, &t->RunStat );
+
+        pINChI2[INCHI_REC] = t->pINChI2[INCHI_REC];
+        pINChI_Aux2[INCHI_REC] = t->pINChI_Aux2[INCHI_REC];
+
+        bRecOk = nRet != _IS_FATAL && nRet != _IS_ERROR &&
+                 t->nRet != _IS_FATAL && t->nRet != _IS_ERROR &&
+                 !IsReconnectedComponentAmbiguous( ip, pINChI2, prep_inp_data ) &&
+                 !t->log_file.s.nUsedLength &&
+                 !t->out_file.s.nUsedLength &&
+                 !t->prb_file.s.nUsedLength;
+
+        if (bRecOk)
+        {
+            /* Merge as if the reconnected layer has been created after the disconnected one */
+            sd->ulStructTime += t->sd.ulStructTime - sd0->ulStructTime;
+            if (t->sd.nErrorCode != sd0->nErrorCode)
+            {
+                sd->nErrorCode = t->sd.nErrorCode;
+            }
+            if (t->sd.nErrorType != sd0->nErrorType)
+            {
+                sd->nErrorType = t->sd.nErrorType;
+            }
+            if (t->sd.nStructReadError != sd0->nStructReadError)
+            {
+                sd->nStructReadError = t->sd.nStructReadError;
+            }
+            if (t->sd.bChiralFlag != sd0->bChiralFlag)
+            {
+                sd->bChiralFlag = t->sd.bChiralFlag;
+            }
+            sd->num_taut[INCHI_REC] = t->sd.num_taut[INCHI_REC];
+            sd->num_non_taut[INCHI_REC] = t->sd.num_non_taut[INCHI_REC];
+            sd->bTautFlags[INCHI_REC] = t->sd.bTautFlags[INCHI_REC];
+            sd->bTautFlagsDone[INCHI_REC] = t->sd.bTautFlagsDone[INCHI_REC];
+            sd->num_components[INCHI_REC] = t->sd.num_components[INCHI_REC];
+#if ( bRELEASE_VERSION == 0 )
+            sd->bExtract |= t->sd.bExtract;
+#endif
+            if (strlen( t->sd.pStrErrStruct ) > strlen( sd0->pStrErrStruct ))
+            {
+                const char *p = t->sd.pStrErrStruct + strlen( sd0->pStrErrStruct );
+                while (*p == ';' || *p == ' ')
+                {
+                    p++;
+                }
+                MergeComponentErrorMessages( sd->pStrErrStruct, p );
+            }
+            for (k = 0; k < TAUT_NUM; k++)
+            {
+                pncFlags->bNormalizationFlags[INCHI_REC][k] = t->ncFlags.bNormalizationFlags[INCHI_REC][k];
+                pncFlags->bTautFlags[INCHI_REC][k] = t->ncFlags.bTautFlags[INCHI_REC][k];
+                pncFlags->bTautFlagsDone[INCHI_REC][k] = t->ncFlags.bTautFlagsDone[INCHI_REC][k];
+                pncFlags->nCanonFlags[INCHI_REC][k] = t->ncFlags.nCanonFlags[INCHI_REC][k];
+            }
+            nRet = inchi_max( nRet, t->nRet );
+            *pbRecDone = 1;
+        }
+        else
+        {
+            /* Discard the reconnected layer */
+            FreeINChIArrays( pINChI2[INCHI_REC], pINChI_Aux2[INCHI_REC], t->sd.num_components[INCHI_REC] );
+            inchi_free( pINChI2[INCHI_REC] );
+            inchi_free( pINChI_Aux2[INCHI_REC] );
+            pINChI2[INCHI_REC] = NULL;
+            pINChI_Aux2[INCHI_REC] = NULL;
+            for (k = 0; k < TAUT_NUM + 1; k++)
+            {
+                FreeCompAtomData( &composite_norm_data[INCHI_REC][k] );
+            }
+            memset( composite_norm_data[INCHI_REC], 0, sizeof( composite_norm_data[0] ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+        }
+
+        inchi_ios_free_str( &t->log_file );
+        inchi_ios_free_str( &t->out_file );
+        inchi_ios_free_str( &t->prb_file );
+    }
+    else
+    {
+        bRecOk = 0;
+    }
+
+    if (!bRecOk &&
+        nRet != _IS_FATAL && nRet != _IS_ERROR &&
+        ( sd->bTautFlagsDone[INCHI_BAS] & TG_FLAG_DISCONNECT_COORD_DONE ))
+    {
+        nRet1 = CreateOneStructureINChI( pCG, ic, sd, ip, szTitle,
+                                         pINChI2, pINChI_Aux2, INCHI_REC,
+                                         inp_file, log_file, out_file, prb_file,
+                                         orig_inp_data, prep_inp_data,
+                                         composite_norm_data,
+                                         num_inp, strbuf, pncFlags );
+        nRet = inchi_max( nRet, nRet1 );
+        *pbRecDone = 1;
+    }
+
+    if (t)
+    {
+        inchi_free( t->pINChI2[INCHI_BAS] );
+        inchi_free( t->pINChI_Aux2[INCHI_BAS] );
+        inchi_free( t );
+    }
+    inchi_free( sd0 );
+
+    *pnRet = nRet;
+
+    return 0;
+}
+#endif /* BUILD_WITH_THREADS */
+
+
 /****************************************************************************
  Generate InChI for the whole (multi-component) structure
 ****************************************************************************/
@@ -1203,6 +1987,27 @@ int CreateOneStructureINChI( CANON_GLOBALS          *pCG,
     pINChI = pINChI2[iINChI];
     pINChI_Aux = pINChI_Aux2[iINChI];
 
+#if ( BUILD_WITH_THREADS == 1 && defined(TARGET_EXE_STANDALONE) )
+    /* Process the components in parallel threads if requested */
+    if (ip->nNumCompThreads && ip->nNumCompThreads != 1 && !ip->bDisplay &&
+        cur_prep_inp_data->num_components > 1)
+    {
+        int bGotoExit = 0;
+        if (!CreateComponentsINChIInThreads( pCG, ic, sd, ip, pINChI2, pINChI_Aux2, iINChI,
+                                             inp_file, log_file, out_file, prb_file,
+                                             prep_inp_data, all_inp_norm_data, num_inp,
+                                             pncFlags, &nRet, &bGotoExit ))
+        {
+            if (bGotoExit)
+            {
+                inchi_free(all_inp_norm_data);
+                goto exit_function;
+            }
+            goto exit_cycle;
+        }
+    }
+#endif
+
     /**************************************************************************/
     /*                                                                        */
     /*                                                                        */
@@ -1233,54 +2038,7 @@ int CreateOneStructureINChI( CANON_GLOBALS          *pCG,
                sd->bUserQuitComponentDisplay) /* djb-rwth: addressing LLVM warning */
         {
             /* Reconnected structure (06-20-2005: added "&& !ip->bDisplayCompositeResults" to display composite structure) */
-            int m = iINChI - 1;
-
-            /* Find whether we have already calculated this INChI in basic (disconnected) layer */
-            for (j = n = 0; j < prep_inp_data[m].num_components; j++)
-            {
-                if (i + 1 == prep_inp_data[m].nOldCompNumber[j] &&
-                    ( pINChI2[m][j][TAUT_NON] || pINChI2[m][j][TAUT_YES] ))
-                {
-                    /* Yes, we have already done this */
-                    if (!n++)
-                    {
-                        memcpy(pINChI + i, pINChI2[m] + j, sizeof(pINChI[0]));
-                        memcpy(pINChI_Aux + i, pINChI_Aux2[m] + j, sizeof(pINChI_Aux[0]));
-                        for (k = 0; k < TAUT_NUM; k++)
-                        {
-                            if (pINChI[i][k])
-                            {
-                                pINChI[i][k]->nRefCount++;
-                                if (pINChI[i][k]->nNumberOfAtoms > 0)
-                                {
-                                    switch (k)
-                                    {
-                                        case TAUT_NON:
-                                            sd->num_non_taut[iINChI] ++;
-                                            break;
-                                        case TAUT_YES:
-                                            if (pINChI[i][k]->lenTautomer > 0)
-                                            {
-                                                sd->num_taut[iINChI] ++;
-                                            }
-                                            else
-                                                if (!pINChI[i][TAUT_NON] ||
-                                                     !pINChI[i][TAUT_NON]->nNumberOfAtoms)
-                                                {
-                                                    sd->num_non_taut[iINChI] ++;
-                                                }
-                                            break;
-                                    }
-                                }
-                            }
-                            if (pINChI_Aux[i][k])
-                            {
-                                pINChI_Aux[i][k]->nRefCount++;
-                            }
-                        }
-                    }
-                }
-            }
+            n = ReuseDisconnectedComponentINChI( sd, pINChI2, pINChI_Aux2, prep_inp_data, iINChI, i );
 
             if (n == 1)
             {
@@ -2045,6 +2803,7 @@ int ProcessOneStructureEx( struct tagINCHI_CLOCK    *ic,
 {
     int ret = _IS_OKAY;
     char *sinchi_noedits=NULL, *saux_noedits=NULL;
+    RUN_STAT RunStat0 = CG->m_RunStat; /* v. 1.07+ */
     
 
     /* PREPROCESS */
@@ -2124,6 +2883,12 @@ int ProcessOneStructureEx( struct tagINCHI_CLOCK    *ic,
     inchi_free(sinchi_noedits);
     inchi_free(saux_noedits);
 
+    /* v. 1.07+: the record did not need the balanced network search at all */
+    if (CG->m_RunStat.lNumPrescreened > RunStat0.lNumPrescreened &&
+        CG->m_RunStat.lNumSearched == RunStat0.lNumSearched)
+    {
+        CG->m_RunStat.lNumRecordsPrescreened++;
+    }
     
 #ifdef TARGET_LIB_FOR_WINCHI
 
@@ -46,6 +46,13 @@
 
 */
 
+#if ( !defined(_WIN32) && !defined(_POSIX_C_SOURCE) )
+#define _POSIX_C_SOURCE 200809L /* v. 1.07+: fseeko(), ftello() */
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64    /* v. 1.07+: 64-bit off_t on 32-bit systems */
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
@@ -203,9 +210,8 @@ int GetOneStructure( INCHI_CLOCK    *ic,
 
             if (bUseFptr)
             {
-                if (fseek( inp_file->f,
-                    struct_fptrs->fptr[struct_fptrs->cur_fptr],
-                    SEEK_SET ))
+                if (inchi_fseek64( inp_file->f,
+                    struct_fptrs->fptr[struct_fptrs->cur_fptr] ))
                 {
                     return _IS_FATAL;
                 }
@@ -273,7 +279,7 @@ int GetOneStructure( INCHI_CLOCK    *ic,
             /* Get the next structure fptr */
             if (bUseFptr)
             {
-                next_fptr = ftell( inp_file->f );
+                next_fptr = inchi_ftell64( inp_file->f );
             }
             else
             {
@@ -290,7 +296,7 @@ int GetOneStructure( INCHI_CLOCK    *ic,
             {
                 if (next_fptr != -1L)
                 {
-                    fseek( inp_file->f, next_fptr, SEEK_SET );
+                    inchi_fseek64( inp_file->f, next_fptr );
                 }
             }
         }
@@ -463,8 +469,8 @@ int ReadTheStructure( struct tagINCHI_CLOCK *ic,
 
                 InchiTimeGet( &ulTStart );
 
-                if (inp_file->type == INCHI_IOS_TYPE_FILE && inp_file->f)
-                    sd->fPtrStart = ( inp_file->f == stdin ) ? -1 : ftell( inp_file->f );
+                if (( inp_file->type == INCHI_IOS_TYPE_FILE || inp_file->type == INCHI_IOS_TYPE_MMAP ) && inp_file->f)
+                    sd->fPtrStart = ( inp_file->f == stdin ) ? -1 : inchi_ios_tell( inp_file );
 
 
                 nRet2 = CreateOrigInpDataFromMolfile( inp_file,
@@ -495,9 +501,9 @@ int ReadTheStructure( struct tagINCHI_CLOCK *ic,
                     ip->lMolfileNumber = 0;
                 }
 
-                if (inp_file->type == INCHI_IOS_TYPE_FILE && inp_file->f)
+                if (( inp_file->type == INCHI_IOS_TYPE_FILE || inp_file->type == INCHI_IOS_TYPE_MMAP ) && inp_file->f)
                 {
-                    sd->fPtrEnd = ( inp_file->f == stdin ) ? -1 : ftell( inp_file->f );
+                    sd->fPtrEnd = ( inp_file->f == stdin ) ? -1 : inchi_ios_tell( inp_file );
                 }
 
                 sd->ulStructTime += InchiTimeElapsed( ic, &ulTStart );
@@ -615,9 +621,9 @@ int ReadTheStructure( struct tagINCHI_CLOCK *ic,
 
                 InchiTimeGet( &ulTStart );
 
-                if (inp_file->type == INCHI_IOS_TYPE_FILE && inp_file->f)
+                if (( inp_file->type == INCHI_IOS_TYPE_FILE || inp_file->type == INCHI_IOS_TYPE_MMAP ) && inp_file->f)
                 {
-                    sd->fPtrStart = ( inp_file->f == stdin ) ? -1 : ftell( inp_file->f );
+                    sd->fPtrStart = ( inp_file->f == stdin ) ? -1 : inchi_ios_tell( inp_file );
                 }
 
 
@@ -637,9 +643,9 @@ int ReadTheStructure( struct tagINCHI_CLOCK *ic,
                                          sd->pStrErrStruct ); /* djb-rwth: ignoring LLVM warning: variable used to store function return value */
 
                 /*if ( !ip->bGetSdfileId || ip->lSdfId == 999999LU) ip->lSdfId = 0;*/
-                if (inp_file->type == INCHI_IOS_TYPE_FILE && inp_file->f)
+                if (( inp_file->type == INCHI_IOS_TYPE_FILE || inp_file->type == INCHI_IOS_TYPE_MMAP ) && inp_file->f)
                 {
-                    sd->fPtrEnd = ( inp_file->f == stdin ) ? -1 : ftell( inp_file->f );
+                    sd->fPtrEnd = ( inp_file->f == stdin ) ? -1 : inchi_ios_tell( inp_file );
                 }
 
                 sd->ulStructTime += InchiTimeElapsed( ic, &ulTStart );
@@ -772,7 +778,7 @@ int TreatErrorsInReadTheStructure( STRUCT_DATA      *sd,
         /* djb-rwth: fixing oss-fuzz issue #27902 */
         if (prb_file && prb_file->f && 0L <= sd->fPtrStart && sd->fPtrStart < sd->fPtrEnd && !ip->bSaveAllGoodStructsAsProblem)
         {
-            MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file->f, *num_inp );
+            MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file, *num_inp );
         }
 #endif
         /* goto exit_function; */
@@ -793,7 +799,7 @@ int TreatErrorsInReadTheStructure( STRUCT_DATA      *sd,
 #if ( bRELEASE_VERSION == 1 || EXTR_FLAGS == 0 )
         if (prb_file && prb_file->f && 0L <= sd->fPtrStart && sd->fPtrStart < sd->fPtrEnd && !ip->bSaveAllGoodStructsAsProblem)
         {
-            MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file->f, *num_inp ); /* djb-rwth: addressing coverity ID #499477 -- return values handled properly */
+            MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file, *num_inp ); /* djb-rwth: addressing coverity ID #499477 -- return values handled properly */
         }
 #endif
     }
@@ -1826,15 +1832,6 @@ void OAD_StructureEdits_DebugPrint(OAD_StructureEdits *ed)
  Prepare CRU fold edits as suggested by the strings with preliminary
  generated interim (1.05+ flavoured) InChI and AuxInfo
 ****************************************************************************/
-/* djb-rwth: placed as global variables to avoid function buffer issues */
-int ec_opp[MAX_ATOMS],		/* equivalence classes for atoms, in order of 1-based orig nums	*/
-ec_cano_opp[MAX_ATOMS],	/* equivalence classes for atoms, in order of 1-based cano nums	*/
-at_stereo_mark_orig_opp[MAX_ATOMS],	/* stereo parities, in order of 1-based orig nums	*/
-xc_opp[MAX_ATOMS];      /* Extended (stereo-aware) atom classes.
-                            There are 'n_ec' non-stereo atom equivalence classes
-                            For ec[i]=k, keep value k for no-stereo atoms while use
-                            (k + neclasses)   for '-' parity
-                            (k + 2*neclasses) for '+' parity                            */
 int  OAD_Polymer_PrepareFoldCRUEdits( ORIG_ATOM_DATA *orig_at_data,
                                       char *sinchi_noedits, 
                                       char *saux_noedits,
@@ -1855,6 +1852,27 @@ int  OAD_Polymer_PrepareFoldCRUEdits( ORIG_ATOM_DATA *orig_at_data,
     OAD_Polymer *p = orig_at_data->polymer;
     int nu = orig_at_data->polymer->n;
 
+    /* djb-rwth: not placed on the stack to avoid function buffer issues;  */
+    /* v. 1.07+: allocated per call rather than globals for reentrancy     */
+    int *ec_opp = NULL,             /* equivalence classes for atoms, in order of 1-based orig nums */
+        *ec_cano_opp,               /* equivalence classes for atoms, in order of 1-based cano nums */
+        *at_stereo_mark_orig_opp,   /* stereo parities, in order of 1-based orig nums               */
+        *xc_opp;                    /* Extended (stereo-aware) atom classes.
+                                       There are 'n_ec' non-stereo atom equivalence classes
+                                       For ec[i]=k, keep value k for no-stereo atoms while use
+                                       (k + neclasses)   for '-' parity
+                                       (k + 2*neclasses) for '+' parity                           */
+
+    ec_opp = (int*)inchi_calloc(4 * (long long)MAX_ATOMS, sizeof(int));
+    if (!ec_opp)
+    {
+        ret = _IS_ERROR;
+        goto exit_function;
+    }
+    ec_cano_opp = ec_opp + MAX_ATOMS;
+    at_stereo_mark_orig_opp = ec_cano_opp + MAX_ATOMS;
+    xc_opp = at_stereo_mark_orig_opp + MAX_ATOMS;
+
     /* Extract cano_nums-->orig_nums mapping from AuxInfo AuxInfo Main Layer */
     orig = (int*)inchi_calloc((long long)nat + 1, sizeof(int)); /* djb-rwth: cast operator added */
     if (!orig)
@@ -1997,6 +2015,10 @@ exit_function:
     {
         inchi_free(all_bkb_orig);
     }
+    if (ec_opp)
+    {
+        inchi_free(ec_opp);
+    }
 
     return ret;
 }
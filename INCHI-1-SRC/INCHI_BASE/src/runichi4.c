@@ -1395,7 +1395,8 @@ int TreatErrorsInCreateOneComponentINChI( STRUCT_DATA *sd,
 {
     if (sd->nErrorCode)
     {
-        AddErrorMessage( sd->pStrErrStruct, ErrMsg( sd->nErrorCode ) );
+        char szErrMsg[ERR_MSG_LEN];
+        AddErrorMessage( sd->pStrErrStruct, ErrMsg( sd->nErrorCode, szErrMsg ) );
         inchi_ios_eprint( log_file,
                           "Error %d (%s) structure #%ld component %d.%s%s%s%s\n",
                           sd->nErrorCode, sd->pStrErrStruct,
@@ -1416,7 +1417,7 @@ int TreatErrorsInCreateOneComponentINChI( STRUCT_DATA *sd,
                  0L <= sd->fPtrStart && sd->fPtrStart < sd->fPtrEnd &&
                  !ip->bSaveAllGoodStructsAsProblem)
             {
-                MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file->f, num_inp );
+                MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file, num_inp );
             }
         }
         else
@@ -1427,7 +1428,7 @@ int TreatErrorsInCreateOneComponentINChI( STRUCT_DATA *sd,
                  0L <= sd->fPtrStart && sd->fPtrStart < sd->fPtrEnd &&
                  !ip->bSaveAllGoodStructsAsProblem)
             {
-                MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file->f, num_inp );
+                MolfileSaveCopy( inp_file, sd->fPtrStart, sd->fPtrEnd, prb_file, num_inp );
             }
         }
 #endif
@@ -1499,7 +1500,7 @@ int TreatCreateINChIWarning( STRUCT_DATA    *sd,
             MolfileSaveCopy( inp_file,
                              sd->fPtrStart,
                              sd->fPtrEnd,
-                             prb_file->f,
+                             prb_file,
                              num_inp );
         }
 
@@ -1511,10 +1512,10 @@ int TreatCreateINChIWarning( STRUCT_DATA    *sd,
                                prb_file->f &&
                                0L <= sd->fPtrStart && sd->fPtrStart < sd->fPtrEnd)
             {
-                MolfileSaveCopy( inp_file->f,
+                MolfileSaveCopy( inp_file,
                                  sd->fPtrStart,
                                  sd->fPtrEnd,
-                                 prb_file->f,
+                                 prb_file,
                                  num_inp );
             }
 #endif
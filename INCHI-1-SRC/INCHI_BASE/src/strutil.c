@@ -2869,8 +2869,8 @@ int DisconnectMetals( ORIG_ATOM_DATA *orig_inp_data,
     int i, j, k, n, iO, num_changes, val, bRadOrMultBonds;
     int num_impl_H, num_at, err, num_disconnected;
     S_CHAR num_explicit_H[NUM_H_ISOTOPES + 1];
-    static char elnumber_Heteroat[16] = { '\0', };
-    static int  num_halogens = 0;
+    char elnumber_Heteroat[16] = { '\0', }; /* v. 1.07+: not static, filled per call for reentrancy */
+    int  num_halogens = 0;
     int num_halogens2;
 
     inp_ATOM  *at = NULL;
@@ -871,24 +871,12 @@ int get_num_H( const char* elname,
                 int bHasMetalNeighbor )
 {
     int val, i, el_number, num_H = 0, num_iso_H;
-    static int intl_el_number_N = 0, intl_el_number_S=0, intl_el_number_O=0, intl_el_number_C=0;
-
-    if (!intl_el_number_N)
-    {
-        intl_el_number_N = el_number_in_internal_ref_table( "N" );
-    }
-    if (!intl_el_number_S)
-    {
-        intl_el_number_S = el_number_in_internal_ref_table( "S" );
-    }
-    if (!intl_el_number_O)
-    {
-        intl_el_number_O = el_number_in_internal_ref_table( "O" );
-    }
-    if (!intl_el_number_C)
-    {
-        intl_el_number_C = el_number_in_internal_ref_table( "C" );
-    }
+    /* v. 1.07+: internal ElData[] numbers are constants rather than lazily  */
+    /* filled static variables; ElData[] has D and T inserted after H, so    */
+    /* the internal number is the periodic table number + 1 for Z > 1        */
+    /* (see get_periodic_table_number())                                     */
+    const int intl_el_number_N = EL_NUMBER_N + 1, intl_el_number_S = EL_NUMBER_S + 1;
+    const int intl_el_number_C = EL_NUMBER_C + 1;
 
 
     /*  atom_input_valence (cValence) cannot be specified in case of */
@@ -607,12 +607,18 @@ int get_endpoint_valence_KET(U_CHAR el_number);
 struct tagCANON_GLOBALS;
 
 /**
- * @brief Frees bit string in canonicalisation data structure
+ * @brief Frees scratch memory arena in canonicalisation data structure
  *
  * @param pCG Canonicalisation data structure
- * @return int 1 if success, 0 if failed
  */
-int SetBitFree(struct tagCANON_GLOBALS *pCG);
+void CanonArenaFree(struct tagCANON_GLOBALS *pCG);
+
+/**
+ * @brief Frees pooled balanced network buffers in canonicalisation data structure
+ *
+ * @param pCG Canonicalisation data structure
+ */
+void BnsPoolFree(struct tagCANON_GLOBALS *pCG);
 
 /**
  * @brief Write coordinate (double) to string
@@ -0,0 +1,507 @@
+/*
+ * International Chemical Identifier (InChI)
+ * Version 1
+ * Software version 1.07
+ * April 30, 2024
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 IUPAC and InChI Trust
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*
+* The InChI library and programs are free software developed under the
+ * auspices of the International Union of Pure and Applied Chemistry (IUPAC).
+ * Originally developed at NIST.
+ * Modifications and additions by IUPAC and the InChI Trust.
+ * Some portions of code were developed/changed by external contributors
+ * (either contractor or volunteer) which are listed in the file
+ * 'External-contributors' included in this distribution.
+ *
+ * info@inchi-trust.org
+ *
+*/
+
+
+#if ( !defined(_WIN32) && !defined(_POSIX_C_SOURCE) )
+#define _POSIX_C_SOURCE 200809L /* v. 1.07+: fseeko(), ftello() */
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64    /* v. 1.07+: 64-bit off_t on 32-bit systems */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "../../../INCHI_BASE/src/mode.h"
+#include "../../../INCHI_BASE/src/incomdef.h"
+#include "../../../INCHI_BASE/src/ichi_io.h"
+#include "../../../INCHI_BASE/src/ichierr.h"
+
+#include "ichiindx.h"
+
+/* Same as in mol_fmt.h, which is not included here since it declares
+   static Molfile reader functions not defined in this file */
+#ifndef SD_FMT_END_OF_DATA
+#define SD_FMT_END_OF_DATA "$$$$"
+#endif
+#ifndef MOL_FMT_INPLINELEN
+#define MOL_FMT_INPLINELEN 204
+#endif
+
+/* mol_fmt4.c */
+int SDFileSkipExtraData( INCHI_IOSTREAM *inp_file, unsigned long *CAS_num, char *comment, int lcomment,
+                         char *name, int lname, int prev_err, const char *pSdfLabel, char *pSdfValue,
+                         char *pStrErr, int bNoWarnings );
+
+
+static const char szSdfIndexMagic[8] = { 'I', 'n', 'C', 'h', 'I', 'I', 'd', 'x' };
+
+
+/****************************************************************************/
+static void PutU32( unsigned char *p, unsigned long v )
+{
+    int i;
+    for (i = 0; i < 4; i++, v >>= 8)
+    {
+        p[i] = (unsigned char) ( v & 0xFF );
+    }
+}
+
+
+/****************************************************************************/
+static void PutU64( unsigned char *p, unsigned long long v )
+{
+    int i;
+    for (i = 0; i < 8; i++, v >>= 8)
+    {
+        p[i] = (unsigned char) ( v & 0xFF );
+    }
+}
+
+
+/****************************************************************************/
+static unsigned long GetU32( const unsigned char *p )
+{
+    return (unsigned long) p[0] | ( (unsigned long) p[1] << 8 ) |
+           ( (unsigned long) p[2] << 16 ) | ( (unsigned long) p[3] << 24 );
+}
+
+
+/****************************************************************************/
+static unsigned long long GetU64( const unsigned char *p )
+{
+    return (unsigned long long) GetU32( p ) | ( (unsigned long long) GetU32( p + 4 ) << 32 );
+}
+
+
+/****************************************************************************
+    FNV-1a hash of the record's title (first) line
+****************************************************************************/
+static unsigned long long TitleHash( const char *p, int len )
+{
+    unsigned long long h = 14695981039346656037ULL;
+    while (len-- > 0)
+    {
+        h ^= (unsigned char) *p++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+
+/****************************************************************************
+    Length of the line in buf without its "\n" or "\r\n"
+****************************************************************************/
+static int LineLen( const INCHI_IOS_STRING *buf )
+{
+    int len = buf->nUsedLength;
+    if (len > 0 && buf->pStr[len - 1] == '\n')
+    {
+        len--;
+        if (len > 0 && buf->pStr[len - 1] == '\r')
+        {
+            len--;
+        }
+    }
+    return len;
+}
+
+
+/****************************************************************************
+    Check whether the line ends an SDfile record: "$$$$" possibly followed
+    by spaces, as the Molfile reader treats it
+****************************************************************************/
+static int IsEndOfRecord( const char *p, int len )
+{
+    if (len < 4 || memcmp( p, SD_FMT_END_OF_DATA, 4 ))
+    {
+        return 0;
+    }
+    for (p += 4, len -= 4; len > 0 && isspace( UCINT *p ); p++, len--)
+    {
+        ;
+    }
+    return !len;
+}
+
+
+/****************************************************************************
+    Size of the input file; the file position is left unchanged
+****************************************************************************/
+static long long InputFileSize( INCHI_IOSTREAM *inp_file )
+{
+    FILE *f = inp_file->f;
+    long long pos, size;
+
+    if (!f || f == stdin || 0 > ( pos = inchi_ftell64( f ) ))
+    {
+        return -1;
+    }
+    if (inchi_fseek64_end( f ) || 0 > ( size = inchi_ftell64( f ) ))
+    {
+        size = -1;
+    }
+    if (inchi_fseek64( f, pos ))
+    {
+        size = -1;
+    }
+
+    return size;
+}
+
+
+/****************************************************************************
+    Name of the index file of the input file; should be freed by the caller
+****************************************************************************/
+char* SdfIndex_MakePath( const char *szInputPath )
+{
+    char *szIndexPath;
+
+    if (!szInputPath || !szInputPath[0])
+    {
+        return NULL;
+    }
+    szIndexPath = (char *) inchi_malloc( strlen( szInputPath ) + sizeof( SDF_INDEX_SUFFIX ) );
+    if (szIndexPath)
+    {
+        strcpy( szIndexPath, szInputPath );
+        strcat( szIndexPath, SDF_INDEX_SUFFIX );
+    }
+
+    return szIndexPath;
+}
+
+
+/****************************************************************************
+    Write one index entry; returns 0 on success
+****************************************************************************/
+static int SdfIndex_PutRecord( FILE *f, long long offset, long long length, unsigned long long hash )
+{
+    unsigned char ent[SDF_INDEX_ENTRY_SIZE];
+
+    PutU64( ent, (unsigned long long) offset );
+    PutU64( ent + 8, (unsigned long long) length );
+    PutU64( ent + 16, hash );
+
+    return 1 != fwrite( ent, sizeof( ent ), 1, f );
+}
+
+
+/****************************************************************************
+    Scan the whole Molfile/SDfile and write the index of its records.
+    A record ends with "$$$$" line; the last record may lack it
+    (a single Molfile) but is indexed only if it is not blank.
+    The input is rewound to its start on return.
+    Returns number of indexed records or -1 on error.
+****************************************************************************/
+long SdfIndex_Build( INCHI_IOSTREAM *inp_file, const char *szIndexPath )
+{
+    INCHI_IOS_STRING line;
+    unsigned char hdr[SDF_INDEX_HEADER_SIZE];
+    long long size, pos, start = -1;
+    unsigned long long hash = 0;
+    long num_records = 0;
+    int bEof = 0, bText = 0, bError = 0, len, i;
+    FILE *f;
+
+    if (0 > ( size = InputFileSize( inp_file ) ) || inchi_ios_seek( inp_file, 0L ))
+    {
+        return -1;
+    }
+    if (0 >= inchi_strbuf_init( &line, INCHI_STRBUF_SMALLER_INITIAL_SIZE, INCHI_STRBUF_SMALLER_SIZE_INCREMENT ))
+    {
+        return -1;
+    }
+    if (!( f = fopen( szIndexPath, "wb" ) ))
+    {
+        inchi_strbuf_close( &line );
+        return -1;
+    }
+
+    /* the header is rewritten when the number of records is known */
+    memset( hdr, 0, sizeof( hdr ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    bError |= 1 != fwrite( hdr, sizeof( hdr ), 1, f );
+
+    while (!bEof && !bError)
+    {
+        pos = inchi_ios_tell( inp_file );
+        inchi_strbuf_reset( &line );
+        bEof = 0 > inchi_strbuf_addline( &line, inp_file, 0, 1 );
+        if (!line.nUsedLength)
+        {
+            break;
+        }
+        len = LineLen( &line );
+        if (start < 0)
+        {
+            start = pos;
+            hash = TitleHash( line.pStr, len );
+            bText = 0;
+        }
+        for (i = 0; i < len && !bText; i++)
+        {
+            bText = !isspace( UCINT line.pStr[i] );
+        }
+        if (IsEndOfRecord( line.pStr, len ))
+        {
+            bError |= SdfIndex_PutRecord( f, start, inchi_ios_tell( inp_file ) - start, hash );
+            num_records++;
+            start = -1;
+        }
+    }
+    if (start >= 0 && bText && !bError)
+    {
+        /* Molfile or the last record without "$$$$" */
+        bError |= SdfIndex_PutRecord( f, start, inchi_ios_tell( inp_file ) - start, hash );
+        num_records++;
+    }
+
+    memcpy( hdr, szSdfIndexMagic, sizeof( szSdfIndexMagic ) );
+    PutU32( hdr + 8, SDF_INDEX_VERSION );
+    PutU32( hdr + 12, SDF_INDEX_ENTRY_SIZE );
+    PutU64( hdr + 16, (unsigned long long) size );
+    PutU64( hdr + 24, (unsigned long long) num_records );
+    bError |= 0 != fseek( f, 0L, SEEK_SET );
+    bError |= 1 != fwrite( hdr, sizeof( hdr ), 1, f );
+    bError |= 0 != fclose( f );
+
+    inchi_strbuf_close( &line );
+    inchi_ios_seek( inp_file, 0L );
+
+    if (bError)
+    {
+        remove( szIndexPath );
+        return -1;
+    }
+
+    return num_records;
+}
+
+
+/****************************************************************************
+    Open the index; it is rejected if it does not match the input file size.
+    Returns 0 on success, -1 if there is no usable index.
+****************************************************************************/
+int SdfIndex_Open( SDF_INDEX *idx, const char *szIndexPath, INCHI_IOSTREAM *inp_file )
+{
+    unsigned char hdr[SDF_INDEX_HEADER_SIZE];
+    long long size;
+
+    memset( idx, 0, sizeof( *idx ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+    if (!szIndexPath || 0 > ( size = InputFileSize( inp_file ) ) ||
+         !( idx->f = fopen( szIndexPath, "rb" ) ))
+    {
+        return -1;
+    }
+    if (1 != fread( hdr, sizeof( hdr ), 1, idx->f ) ||
+         memcmp( hdr, szSdfIndexMagic, sizeof( szSdfIndexMagic ) ) ||
+         GetU32( hdr + 8 ) != SDF_INDEX_VERSION ||
+         GetU32( hdr + 12 ) != SDF_INDEX_ENTRY_SIZE ||
+         GetU64( hdr + 16 ) != (unsigned long long) size ||
+         GetU64( hdr + 24 ) > (unsigned long long) ( ( LONG_MAX - SDF_INDEX_HEADER_SIZE ) / SDF_INDEX_ENTRY_SIZE ))
+    {
+        SdfIndex_Close( idx );
+        return -1;
+    }
+    idx->num_records = (long) GetU64( hdr + 24 );
+
+    return 0;
+}
+
+
+/****************************************************************************
+    Get the entry of record nRecord = 1, 2, ...
+    Returns 0 on success, -1 if the record is not in the index.
+****************************************************************************/
+int SdfIndex_GetRecord( SDF_INDEX *idx, long nRecord, SDF_INDEX_RECORD *rec )
+{
+    unsigned char ent[SDF_INDEX_ENTRY_SIZE];
+
+    if (!idx->f || nRecord < 1 || nRecord > idx->num_records ||
+         fseek( idx->f, SDF_INDEX_HEADER_SIZE + ( nRecord - 1 ) * SDF_INDEX_ENTRY_SIZE, SEEK_SET ) ||
+         1 != fread( ent, sizeof( ent ), 1, idx->f ))
+    {
+        return -1;
+    }
+    rec->offset = (long long) GetU64( ent );
+    rec->length = (long long) GetU64( ent + 8 );
+    rec->title_hash = GetU64( ent + 16 );
+
+    return 0;
+}
+
+
+/****************************************************************************
+    Position the input at the start of record nRecord after checking that
+    its title line is the indexed one.
+    Returns 0 on success, -1 (the input position is unchanged) otherwise.
+****************************************************************************/
+int SdfIndex_SeekRecord( SDF_INDEX *idx, INCHI_IOSTREAM *inp_file, long nRecord )
+{
+    SDF_INDEX_RECORD rec;
+    INCHI_IOS_STRING line;
+    long long pos = inchi_ios_tell( inp_file );
+    int ret = -1;
+
+    if (pos < 0 || SdfIndex_GetRecord( idx, nRecord, &rec ) ||
+         0 >= inchi_strbuf_init( &line, INCHI_STRBUF_SMALLER_INITIAL_SIZE, INCHI_STRBUF_SMALLER_SIZE_INCREMENT ))
+    {
+        return -1;
+    }
+    if (!inchi_ios_seek( inp_file, rec.offset ))
+    {
+        inchi_strbuf_addline( &line, inp_file, 0, 1 );
+        if (rec.title_hash == TitleHash( line.pStr, LineLen( &line ) ))
+        {
+            ret = inchi_ios_seek( inp_file, rec.offset );
+        }
+    }
+    if (ret)
+    {
+        inchi_ios_seek( inp_file, pos );
+    }
+    inchi_strbuf_close( &line );
+
+    return ret;
+}
+
+
+/****************************************************************************
+    Position the input at the first record of byte range shard nShard
+    (0, 1, ..., nNumShards-1), that is, at the first record starting at or
+    after size*nShard/nNumShards. The shard ends before the first record
+    starting at or after size*(nShard+1)/nNumShards, *pEnd.
+    With a matching index the record is found by a binary search over the
+    index entries. Otherwise the input is read from a few bytes before the
+    range start, resynchronized on the next "$$$$" line with
+    SDFileSkipExtraData() as after a bad record; the preceding records are
+    not counted (that would cost a scan of the whole file prefix in every
+    shard), so *num_before is 0 and structure numbers are shard-relative.
+    Returns 1 if the index has been used, 0 if not, -1 on error.
+****************************************************************************/
+int SdfIndex_SeekShard( INCHI_IOSTREAM *inp_file,
+                        const char *szIndexPath,
+                        int nShard,
+                        int nNumShards,
+                        long *num_before,
+                        long long *pEnd )
+{
+    SDF_INDEX idx;
+    long long size, lo, pos;
+    char line[MOL_FMT_INPLINELEN];
+    char szErr[STR_ERR_LEN];
+
+    if (nNumShards < 1 || nShard < 0 || nShard >= nNumShards ||
+         0 > ( size = InputFileSize( inp_file ) ))
+    {
+        return -1;
+    }
+    lo = size * nShard / nNumShards;
+    *pEnd = size * ( nShard + 1 ) / nNumShards;
+    *num_before = 0;
+
+    if (!SdfIndex_Open( &idx, szIndexPath, inp_file ))
+    {
+        /* find the first record with offset >= lo */
+        SDF_INDEX_RECORD rec;
+        long a = 1, b = idx.num_records + 1, m;
+        int ret = 0;
+        while (a < b && !( ret = SdfIndex_GetRecord( &idx, m = a + ( b - a ) / 2, &rec ) ))
+        {
+            if (rec.offset >= lo)
+            {
+                b = m;
+            }
+            else
+            {
+                a = m + 1;
+            }
+        }
+        if (!ret)
+        {
+            ret = ( a > idx.num_records ) ? inchi_ios_seek( inp_file, size )
+                                          : SdfIndex_SeekRecord( &idx, inp_file, a );
+        }
+        SdfIndex_Close( &idx );
+        if (!ret)
+        {
+            *num_before = a - 1;
+            return 1;
+        }
+    }
+
+    pos = 0;
+    if (lo > 0)
+    {
+        /* start at a line beginning so that a "$$$$" line ending at */
+        /* or after lo cannot be missed                              */
+        pos = inchi_max( lo - MOL_FMT_INPLINELEN, 1 ) - 1;
+        if (inchi_ios_seek( inp_file, pos ) || !inchi_fgetsLf( line, sizeof( line ), inp_file ))
+        {
+            pos = size;
+        }
+        while (pos < lo)
+        {
+            long long prev = inchi_ios_tell( inp_file );
+            SDFileSkipExtraData( inp_file, NULL, NULL, 0, NULL, 0, 1, NULL, NULL, szErr, 1 );
+            pos = inchi_ios_tell( inp_file );
+            if (pos <= prev || pos < 0)
+            {
+                pos = size; /* end of file */
+            }
+        }
+    }
+
+    return inchi_ios_seek( inp_file, pos ) ? -1 : 0;
+}
+
+
+/****************************************************************************/
+void SdfIndex_Close( SDF_INDEX *idx )
+{
+    if (idx->f)
+    {
+        fclose( idx->f );
+    }
+    memset( idx, 0, sizeof( *idx ) ); /* djb-rwth: memset_s C11/Annex K variant? */
+}
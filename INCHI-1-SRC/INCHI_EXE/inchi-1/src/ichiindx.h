@@ -0,0 +1,104 @@
+/*
+ * International Chemical Identifier (InChI)
+ * Version 1
+ * Software version 1.07
+ * April 30, 2024
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 IUPAC and InChI Trust
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*
+* The InChI library and programs are free software developed under the
+ * auspices of the International Union of Pure and Applied Chemistry (IUPAC).
+ * Originally developed at NIST.
+ * Modifications and additions by IUPAC and the InChI Trust.
+ * Some portions of code were developed/changed by external contributors
+ * (either contractor or volunteer) which are listed in the file
+ * 'External-contributors' included in this distribution.
+ *
+ * info@inchi-trust.org
+ *
+*/
+
+
+#ifndef _ICHIINDX_H_
+#define _ICHIINDX_H_
+
+
+/*
+    Sidecar index of Molfile/SDfile input records (v. 1.07+)
+
+    The index '<input file>.idx' is written by 'inchi-1 input.sdf -BuildIndex'
+    and used to start at START:n or at the first record of a Shard:k/N
+    byte range without reading the preceding records.
+    Binary format, all numbers are unsigned little-endian:
+
+        header  : "InChIIdx", u32 version, u32 entry size,
+                  u64 input file size, u64 number of records
+        entries : u64 record offset, u64 record length, u64 title line hash
+
+    The entry of record n (1, 2, ...) is at header size + (n-1)*entry size.
+*/
+
+#define SDF_INDEX_SUFFIX        ".idx"
+#define SDF_INDEX_VERSION       1
+#define SDF_INDEX_HEADER_SIZE   32
+#define SDF_INDEX_ENTRY_SIZE    24
+
+
+typedef struct tagSdfIndexRecord
+{
+    long long           offset;         /* start of the record in the input file  */
+    long long           length;         /* up to and including "$$$$" line        */
+    unsigned long long  title_hash;     /* FNV-1a hash of the record's first line */
+} SDF_INDEX_RECORD;
+
+typedef struct tagSdfIndex
+{
+    FILE                *f;
+    long                num_records;
+} SDF_INDEX;
+
+
+#ifndef COMPILE_ALL_CPP
+#ifdef __cplusplus
+extern "C" {
+#endif
+#endif
+
+    char* SdfIndex_MakePath( const char *szInputPath );
+    long SdfIndex_Build( INCHI_IOSTREAM *inp_file, const char *szIndexPath );
+    int SdfIndex_Open( SDF_INDEX *idx, const char *szIndexPath, INCHI_IOSTREAM *inp_file );
+    int SdfIndex_GetRecord( SDF_INDEX *idx, long nRecord, SDF_INDEX_RECORD *rec );
+    int SdfIndex_SeekRecord( SDF_INDEX *idx, INCHI_IOSTREAM *inp_file, long nRecord );
+    int SdfIndex_SeekShard( INCHI_IOSTREAM *inp_file, const char *szIndexPath,
+                            int nShard, int nNumShards,
+                            long *num_before, long long *pEnd );
+    void SdfIndex_Close( SDF_INDEX *idx );
+
+#ifndef COMPILE_ALL_CPP
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+
+#endif /* _ICHIINDX_H_ */
@@ -78,6 +78,8 @@
 #include "../../../INCHI_BASE/src/ichimain.h"
 #include "../../../INCHI_BASE/src/ichicomp.h"
 #include "../../../INCHI_BASE/src/ichi_io.h"
+#include "../../../INCHI_BASE/src/ichithrd.h"
+#include "../../../INCHI_BASE/src/ichi_bns.h"
 #ifdef TARGET_EXE_STANDALONE
 #include "../../../INCHI_BASE/src/inchi_api.h"
 #endif
@@ -85,6 +87,8 @@
 #include "../../../INCHI_BASE/src/bcf_s.h"
 #include "../../../INCHI_BASE/src/permutation_util.h"
 
+#include "ichiindx.h"
+
  /*  Console-specific */
 
 #if !defined(TARGET_API_LIB) && !defined(COMPILE_ANSI_ONLY)
@@ -262,11 +266,190 @@ int main(int argc, char* argv[])
 }
 
 
+#if ( BUILD_WITH_THREADS == 1 )
+
+/*
+    Multi-threaded AMI mode (option AMIThreads:N)
+
+    The main thread makes the argument vectors for the input files as in
+    the serial mode and queues them; each of N worker threads processes
+    one file at a time with ProcessSingleInputFileEx(). Since the queue
+    is bounded and every worker opens only the files of its current
+    input, at most N inputs (and their out/log/problem files) are open
+    simultaneously. The totals are summed up for the final summary.
+    With AMIOutStd or AMILogStd all files would write to the same stream
+    and their records would interleave, so the files are then processed
+    one by one.
+*/
+
+typedef struct tagAmiJob
+{
+    int                 targc;
+    char              **targv;          /* own copy of the argument vector  */
+    char               *fn_in;          /* own copies of the file names     */
+    char               *fn_out;
+    char               *fn_log;
+    char               *fn_prb;
+    struct tagAmiJob   *next;
+} AMI_JOB;
+
+typedef struct tagAmiPool
+{
+    INCHI_MUTEX         mutex;
+    INCHI_COND          cond;           /* signalled on queue change or quit */
+    AMI_JOB            *head;
+    AMI_JOB            *tail;
+    int                 num_queued;
+    int                 max_queued;
+    int                 bNoMoreJobs;
+    int                 bQuit;
+    int                 num_files;      /* number of processed input files  */
+    INPUT_FILE_TOTALS   totals;
+} AMI_POOL;
+
+
+/*****************************************************************************/
+static void AmiJobFree(AMI_JOB* job)
+{
+    if (job)
+    {
+        inchi_free(job->targv);
+        inchi_free(job->fn_in);
+        inchi_free(job->fn_out);
+        inchi_free(job->fn_log);
+        inchi_free(job->fn_prb);
+        inchi_free(job);
+    }
+}
+
+
+/*****************************************************************************/
+static void AmiPoolWorker(void* arg)
+{
+    AMI_POOL* pool = (AMI_POOL*)arg;
+    AMI_JOB* job;
+    INPUT_FILE_TOTALS totals;
+    int ret;
+
+    for (;;)
+    {
+        inchi_mutex_lock(&pool->mutex);
+        while (!pool->head && !pool->bNoMoreJobs && !pool->bQuit)
+        {
+            inchi_cond_wait(&pool->cond, &pool->mutex);
+        }
+        if (pool->bQuit || !pool->head)
+        {
+            inchi_mutex_unlock(&pool->mutex);
+            break;
+        }
+        job = pool->head;
+        pool->head = job->next;
+        if (!pool->head)
+        {
+            pool->tail = NULL;
+        }
+        pool->num_queued--;
+        inchi_cond_broadcast(&pool->cond);
+        inchi_mutex_unlock(&pool->mutex);
+
+        memset(&totals, 0, sizeof(totals)); /* djb-rwth: memset_s C11/Annex K variant? */
+        ret = ProcessSingleInputFileEx(job->targc, job->targv, &totals);
+        AmiJobFree(job);
+
+        inchi_mutex_lock(&pool->mutex);
+        pool->num_files++;
+        pool->totals.num_inp += totals.num_inp;
+        pool->totals.num_err += totals.num_err;
+        pool->totals.ulProcessingTime += totals.ulProcessingTime;
+#if ( defined( _WIN32 ) && defined( _CONSOLE ) && !defined( COMPILE_ANSI_ONLY ) )
+        if (ret == CTRL_STOP_EVENT)
+        {
+            pool->bQuit = 1;
+            inchi_cond_broadcast(&pool->cond);
+        }
+#endif
+        inchi_mutex_unlock(&pool->mutex);
+    }
+}
+
+
+/*****************************************************************************
+ Queue the input file; the job takes the ownership of the output names
+ Returns 0 on success, -1 if processing has been interrupted,
+ 1 if out of memory (the names are left to the caller)
+*****************************************************************************/
+static int AmiPoolAddJob(AMI_POOL* pool,
+    int targc,
+    char* targv[],
+    const char* fn_in,
+    char** fn_out,
+    char** fn_log,
+    char** fn_prb)
+{
+    AMI_JOB* job = (AMI_JOB*)inchi_calloc(1, sizeof(*job));
+    int i;
+
+    if (!job ||
+        !(job->targv = (char**)inchi_calloc((long long)targc + 1, sizeof(char*))) || /* djb-rwth: cast operator added */
+        !(job->fn_in = (char*)inchi_malloc(strlen(fn_in) + 1)))
+    {
+        AmiJobFree(job);
+        return 1;
+    }
+    /* the name of the input may be in a reused buffer */
+    strcpy(job->fn_in, fn_in);
+    for (i = 0; i < targc; i++)
+    {
+        job->targv[i] = targv[i];
+    }
+    job->targv[1] = job->fn_in;
+    job->targc = targc;
+    job->fn_out = *fn_out;
+    job->fn_log = *fn_log;
+    job->fn_prb = *fn_prb;
+    *fn_out = *fn_log = *fn_prb = NULL;
+
+    inchi_mutex_lock(&pool->mutex);
+    while (pool->num_queued >= pool->max_queued && !pool->bQuit)
+    {
+        inchi_cond_wait(&pool->cond, &pool->mutex);
+    }
+    if (pool->bQuit)
+    {
+        inchi_mutex_unlock(&pool->mutex);
+        AmiJobFree(job);
+        return -1;
+    }
+    if (pool->tail)
+    {
+        pool->tail->next = job;
+    }
+    else
+    {
+        pool->head = job;
+    }
+    pool->tail = job;
+    pool->num_queued++;
+    inchi_cond_broadcast(&pool->cond);
+    inchi_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+#endif /* BUILD_WITH_THREADS */
+
+
 /****************************************************************************/
 int ProcessMultipleInputFiles(int argc, char* argv[])
 {
     int i, ret = 0, nfn_ins = 0,
         AMIOutStd = 0, AMILogStd = 0, AMIPrbNone = 0;
+#if ( BUILD_WITH_THREADS == 1 )
+    int nAMIThreads = 1, num_threads_started = 0;
+    AMI_POOL pool;
+    INCHI_THREAD* threads = NULL;
+#endif
     char* fn_out, * fn_log, * fn_prb;
     char pNUL[] = "NUL";
     char** fn_ins = NULL, ** targv = NULL;
@@ -318,6 +501,16 @@ int ProcessMultipleInputFiles(int argc, char* argv[])
             {
                 AMIPrbNone = 1;
             }
+#if ( BUILD_WITH_THREADS == 1 )
+            else if (!inchi_memicmp(argv[i] + 1, "AMIThreads:", 11))
+            {
+                nAMIThreads = (int)strtol(argv[i] + 12, NULL, 10);
+                if (nAMIThreads <= 0)
+                {
+                    nAMIThreads = inchi_num_cpus();
+                }
+            }
+#endif
 #if( BUILD_WITH_AMI == 1 && defined( _MSC_VER ) && MSC_AMI == 1 )
             else if (!inchi_memicmp(argv[i] + 1, "OP:", 3))
             {
@@ -346,6 +539,37 @@ int ProcessMultipleInputFiles(int argc, char* argv[])
         goto exit_ami;
     }
 
+#if ( BUILD_WITH_THREADS == 1 )
+    memset(&pool, 0, sizeof(pool)); /* djb-rwth: memset_s C11/Annex K variant? */
+    if (nAMIThreads > 1 && (AMIOutStd || AMILogStd))
+    {
+        fprintf(stderr, "Option AMIThreads is not compatible with AMIOutStd and AMILogStd; input files are processed one by one.\n");
+        nAMIThreads = 1;
+    }
+    if (nAMIThreads > 1)
+    {
+        pool.max_queued = nAMIThreads;
+        threads = (INCHI_THREAD*)inchi_calloc(nAMIThreads, sizeof(threads[0]));
+        if (threads &&
+            !inchi_mutex_init(&pool.mutex) &&
+            !inchi_cond_init(&pool.cond))
+        {
+            for (i = 0; i < nAMIThreads; i++)
+            {
+                if (inchi_thread_create(threads + num_threads_started, AmiPoolWorker, &pool))
+                {
+                    break;
+                }
+                num_threads_started++;
+            }
+        }
+        if (!num_threads_started)
+        {
+            fprintf(stderr, "Cannot start threads; input files are processed one by one.\n");
+        }
+    }
+#endif
+
 #if( BUILD_WITH_AMI == 1 && defined( _MSC_VER ) && MSC_AMI == 1 )
     if ((pName = strrchr(fn_ins[0], INCHI_PATH_DELIM))) /* djb-rwth: addressing LLVM warning */
     {
@@ -474,7 +698,20 @@ int ProcessMultipleInputFiles(int argc, char* argv[])
             targv[targc] = NULL;
         }
 
-        ret = ProcessSingleInputFile(targc, targv); /* ProcessSingleInputFile() is a former main() */
+#if ( BUILD_WITH_THREADS == 1 )
+        if (num_threads_started &&
+            0 >= (ret = AmiPoolAddJob(&pool, targc, targv, fn_in, &fn_out, &fn_log, &fn_prb)))
+        {
+            if (ret < 0)
+            {
+                goto exit_ami;
+            }
+        }
+        else /* not enough memory for the job: process in this thread */
+#endif
+        {
+            ret = ProcessSingleInputFile(targc, targv); /* ProcessSingleInputFile() is a former main() */
+        }
 
         if (fn_out)
         {
@@ -504,6 +741,41 @@ exit_ami:
     {
         _findclose(hFile);
     }
+#endif
+#if ( BUILD_WITH_THREADS == 1 )
+    if (num_threads_started)
+    {
+        int hours, minutes, seconds, mseconds;
+
+        inchi_mutex_lock(&pool.mutex);
+        pool.bNoMoreJobs = 1;
+        inchi_cond_broadcast(&pool.cond);
+        inchi_mutex_unlock(&pool.mutex);
+        for (i = 0; i < num_threads_started; i++)
+        {
+            inchi_thread_join(threads + i);
+        }
+        while (pool.head)
+        {
+            /* left after interruption */
+            AMI_JOB* job = pool.head;
+            pool.head = job->next;
+            AmiJobFree(job);
+        }
+        inchi_cond_destroy(&pool.cond);
+        inchi_mutex_destroy(&pool.mutex);
+
+        SplitTime(pool.totals.ulProcessingTime, &hours, &minutes, &seconds, &mseconds);
+        fprintf(stderr, "Finished processing %d input file%s: %ld structure%s, %ld error%s, processing time %d:%02d:%02d.%02d\n",
+            pool.num_files, pool.num_files == 1 ? "" : "s",
+            pool.totals.num_inp, pool.totals.num_inp == 1 ? "" : "s",
+            pool.totals.num_err, pool.totals.num_err == 1 ? "" : "s",
+            hours, minutes, seconds, mseconds / 10);
+    }
+    if (threads)
+    {
+        inchi_free(threads);
+    }
 #endif
     if (targv)
     {
@@ -521,6 +793,16 @@ exit_ami:
 
 /****************************************************************************/
 int ProcessSingleInputFile(int argc, char* argv[])
+{
+    return ProcessSingleInputFileEx(argc, argv, NULL);
+}
+
+
+/****************************************************************************
+ Same as ProcessSingleInputFile(); if totals is not NULL, it receives
+ the numbers of processed structures and errors and the processing time
+****************************************************************************/
+int ProcessSingleInputFileEx(int argc, char* argv[], INPUT_FILE_TOTALS* totals)
 {
     /**************************************/
 #endif /* #if ( BUILD_WITH_AMI == 1 ) */
@@ -690,6 +972,15 @@ int ProcessSingleInputFile(int argc, char* argv[])
         goto exit_function;
     }
 
+#if ( BUILD_WITH_MMAP == 1 )
+    /* Read Molfile/SDfile/InChI from memory; internal test mode needs plain file */
+    if ((ip->nInputType == INPUT_MOLFILE || ip->nInputType == INPUT_SDFILE ||
+         ip->nInputType == INPUT_INCHI) && !pStructPtrs)
+    {
+        inchi_ios_mmap(inp_file); /* if failed, read from file */
+    }
+#endif
+
 
     if (ip->bNoStructLabels)
     {
@@ -725,6 +1016,77 @@ int ProcessSingleInputFile(int argc, char* argv[])
         goto exit_function;
     }
 
+    /* Sidecar index of SDfile records: build it or use it to skip to START:n; */
+    /* byte range shard of the input                                          */
+    if (ip->bBuildIndex || ip->first_struct_number > 1 || ip->nNumShards > 1)
+    {
+        char* szIndexPath = NULL;
+        if ((ip->nInputType == INPUT_MOLFILE || ip->nInputType == INPUT_SDFILE) && !pStructPtrs)
+        {
+            szIndexPath = SdfIndex_MakePath(ip->path[0]);
+        }
+        if (ip->bBuildIndex)
+        {
+            long num_rec = szIndexPath ? SdfIndex_Build(inp_file, szIndexPath) : -1;
+            if (num_rec >= 0)
+            {
+                inchi_ios_eprint(plog, "Index of %ld record%s written to '%s'\n",
+                    num_rec, num_rec == 1 ? "" : "s", szIndexPath);
+            }
+            else
+            {
+                inchi_ios_eprint(plog, "Cannot write index of the input %s. Terminating\n",
+                    szIndexPath ? "file" : "(Molfile/SDfile required)");
+            }
+            inchi_ios_flush2(plog, stderr);
+            inchi_free(szIndexPath);
+            goto exit_function;
+        }
+        if (ip->nNumShards > 1)
+        {
+            long long shard_end = 0;
+            long num_before = 0;
+            int ret = szIndexPath ? SdfIndex_SeekShard(inp_file, szIndexPath, ip->nShard, ip->nNumShards,
+                &num_before, &shard_end) : -1;
+            if (ret < 0)
+            {
+                inchi_ios_eprint(plog, "Cannot locate shard %d/%d of the input %s. Terminating\n",
+                    ip->nShard, ip->nNumShards, szIndexPath ? "file" : "(Molfile/SDfile required)");
+                inchi_ios_flush2(plog, stderr);
+                inchi_free(szIndexPath);
+                goto exit_function;
+            }
+            num_inp = num_before;
+            ip->lShardEnd = shard_end;
+            if (ret)
+            {
+                inchi_ios_eprint(plog, "Shard %d/%d starts at structure #%ld (located using index)\n",
+                    ip->nShard, ip->nNumShards, num_before + 1);
+            }
+            else
+            {
+                inchi_ios_eprint(plog, "Shard %d/%d: no index of the input file, structure numbers are\n"
+                    "relative to the shard (run with -BuildIndex first to number them as in the whole file)\n",
+                    ip->nShard, ip->nNumShards);
+            }
+        }
+        else if (szIndexPath)
+        {
+            SDF_INDEX idx;
+            if (!SdfIndex_Open(&idx, szIndexPath, inp_file))
+            {
+                if (!SdfIndex_SeekRecord(&idx, inp_file, ip->first_struct_number))
+                {
+                    num_inp = ip->first_struct_number - 1;
+                    inchi_ios_eprint(plog, "Structure #%ld located using index '%s'\n",
+                        ip->first_struct_number, szIndexPath);
+                }
+                SdfIndex_Close(&idx);
+            }
+            inchi_free(szIndexPath);
+        }
+    }
+
 
     /* Process InChI string as input; output may be   */
     /* a) InChI string or b) structure                */
@@ -744,7 +1106,8 @@ int ProcessSingleInputFile(int argc, char* argv[])
             {
                 char* p, * pi;
 
-                read_result = inchi_strbuf_getline(pTmpIn, inp_file->f, crlf2lf, preserve_lf);
+                inchi_strbuf_reset(pTmpIn);
+                read_result = inchi_strbuf_addline(pTmpIn, inp_file, crlf2lf, preserve_lf);
 
                 if (read_result == -1)
 #if (FIX_ONE_LINE_INCHI_INPUT_CONVERSION_ISSUE==1)
@@ -790,8 +1153,8 @@ int ProcessSingleInputFile(int argc, char* argv[])
             /* loop through file lines within ReadWriteInChI */
             ReadWriteInChI(&ic, &CG, inp_file, pout, plog, ip, sd, NULL, 0, 0, NULL, NULL, NULL, 0, NULL);
 
-            num_inp = sd->fPtrStart;
-            num_err = sd->fPtrEnd;
+            num_inp = (long) sd->fPtrStart;
+            num_err = (long) sd->fPtrEnd;
         }
 
         inchi_ios_flush2(plog, stderr);
@@ -810,6 +1173,27 @@ int ProcessSingleInputFile(int argc, char* argv[])
     }
     output_error_inchi = ip->bINChIOutputOptions2 & INCHI_OUT_INCHI_GEN_ERROR;
 
+#if ( BUILD_WITH_THREADS == 1 )
+    /* Multi-threaded processing; internal test modes and display */
+    /* are always treated in the main cycle                       */
+    if (ip->nNumThreads && ip->nNumThreads != 1 &&
+        !pStructPtrs && !ip->bDisplay
+#if ( RENUMBER_ATOMS_AND_RECALC_V106 == 1 )
+        && ip->bRenumber != 1
+#endif
+        )
+    {
+        int num_threads = ip->nNumThreads > 0 ? ip->nNumThreads : inchi_num_cpus();
+        if (num_threads > 1 &&
+            !ProcessInputRecordsInThreads(&ic, ip, inp_file, plog, pout, pprb,
+                num_threads, output_error_inchi, pLF, pTAB,
+                &num_inp, &num_err, &ulTotalProcessingTime, &CG.m_RunStat))
+        {
+            goto exit_function;
+        }
+    }
+#endif
+
 
     /*************************************************************/
     /*  Main cycle : read input structures and create their INChI                                  */
@@ -827,6 +1211,8 @@ int ProcessSingleInputFile(int argc, char* argv[])
         char ikey0[28];
         ikey0[0] = '\0';
 
+        /* write out problem structures saved while treating the previous record */
+        inchi_ios_flush(pprb);
 
         next_action = GetTheNextRecordOfInputFile(&ic, sd, ip, szTitle,
             inp_file, plog, pout, pprb,
@@ -998,9 +1384,11 @@ exit_function:
     /* Close files */
     inchi_ios_close(inp_file);
     inchi_ios_close(pout);
+    inchi_ios_flush(pprb);
     inchi_ios_close(pprb);
     {
         int hours, minutes, seconds, mseconds;
+        RUN_STAT RunStat; /* v. 1.07+: of all threads */
 
         SplitTime(ulTotalProcessingTime, &hours, &minutes, &seconds, &mseconds);
 
@@ -1008,8 +1396,30 @@ exit_function:
             num_inp, num_inp == 1 ? "" : "s",
             num_err, num_err == 1 ? "" : "s",
             hours, minutes, seconds, mseconds / 10);
+
+        memset(&RunStat, 0, sizeof(RunStat)); /* djb-rwth: memset_s C11/Annex K variant? */
+        RunStatAddCG(&RunStat, &CG);
+        inchi_ios_eprint(plog, "Balanced network search: skipped in %ld record%s, %ld of %ld normalizations\n",
+            RunStat.lNumRecordsPrescreened, RunStat.lNumRecordsPrescreened == 1 ? "" : "s",
+            RunStat.lNumPrescreened, RunStat.lNumPrescreened + RunStat.lNumSearched);
+#if ( bRELEASE_VERSION == 0 )
+        inchi_ios_eprint(plog, "Canonicalization scratch memory: %ld allocations served from arenas of up to %lu bytes, %ld from the heap\n",
+            RunStat.lNumArenaAllocs, (unsigned long)RunStat.nArenaSize, RunStat.lNumArenaHeapAllocs);
+        inchi_ios_eprint(plog, "Balanced network buffers: %ld served from the pool, %ld arrays (re)allocated\n",
+            RunStat.lNumBnsReused, RunStat.lNumBnsAllocated);
+        inchi_ios_eprint(plog, "Stereo canonicalization: %ld atom mapping%s tried\n",
+            RunStat.lNumStereoMappings, RunStat.lNumStereoMappings == 1 ? "" : "s");
+#endif
         inchi_ios_flush2(plog, stderr);
     }
+#if ( BUILD_WITH_AMI == 1 )
+    if (totals)
+    {
+        totals->num_inp = num_inp;
+        totals->num_err = num_err;
+        totals->ulProcessingTime = ulTotalProcessingTime;
+    }
+#endif
 #if ( defined(_WIN32) && defined(_MSC_VER) )
 #if WINVER >= 0x0501 /* XP or newer */ /* 0x0600 Vista or newer */
     tick_inchi_stop = GetTickCount64(); /* djb-rwth: GetTickCount64() should be used */
@@ -1028,7 +1438,9 @@ exit_function:
             ip->path[i] = NULL;
         }
     }
-    SetBitFree(&CG);
+    CanonArenaFree(&CG);
+    BnsPoolFree(&CG);
+    RingCacheFree(&CG.m_RingCache);
 #if ( ( BUILD_WITH_AMI==1 ) && defined( _WIN32 ) && defined( _CONSOLE ) && !defined( COMPILE_ANSI_ONLY ) )
     if (bInterrupted)
     {
@@ -1076,11 +1488,34 @@ void emit_empty_inchi(INPUT_PARMS* ip,
     {
         inchi_ios_eprint(pout, "InChI=1//\n"); /* emit empty InChI */
     }
-    inchi_ios_flush(pout);
+    flush_record_stream(pout, NULL);
 }
 #endif  /* ifndef TARGET_LIB_FOR_WINCHI */
 
 
+/*****************************************************************************
+ Flush per-record output (echoing to f2 if not NULL).
+ A string stream without associated file keeps its contents: this is
+ a per-record buffer which is written later, in the order of input
+ records, by the multi-threaded driver.
+*****************************************************************************/
+void flush_record_stream(INCHI_IOSTREAM* ios, FILE* f2)
+{
+    if (ios->type == INCHI_IOS_TYPE_STRING && !ios->f)
+    {
+        return;
+    }
+    if (f2)
+    {
+        inchi_ios_flush2(ios, f2);
+    }
+    else
+    {
+        inchi_ios_flush(ios);
+    }
+}
+
+
 /*****************************************************************************/
 int GetTheNextRecordOfInputFile(struct tagINCHI_CLOCK* ic,
     STRUCT_DATA* sd, INPUT_PARMS* ip,
@@ -1102,13 +1537,18 @@ int GetTheNextRecordOfInputFile(struct tagINCHI_CLOCK* ic,
         *nRet = _IS_EOF; /*  simulate end of file */
         return DO_EXIT_FUNCTION;
     }
+    if (ip->nNumShards > 1 && inchi_ios_tell(inp_file) >= ip->lShardEnd)
+    {
+        *nRet = _IS_EOF; /*  the next record belongs to the next shard */
+        return DO_EXIT_FUNCTION;
+    }
 
 
     *nRet = GetOneStructure(ic, sd, ip, szTitle, inp_file,
         plog, pout, pprb, orig_inp_data,
         num_inp, pStructPtrs);
 
-    inchi_ios_flush2(plog, stderr);
+    flush_record_stream(plog, stderr);
 
     if (pStructPtrs)
         pStructPtrs->cur_fptr++;
@@ -1213,7 +1653,7 @@ int CalcAndPrintINCHIAndINCHIKEY(struct tagINCHI_CLOCK* ic,
         *num_inp, strbuf,
         0 /* save_opt_bits */);
 
-    inchi_ios_flush2(plog, stderr);
+    flush_record_stream(plog, stderr);
 
 
     /* Output InChI */
@@ -1291,7 +1731,7 @@ int CalcAndPrintINCHIAndINCHIKEY(struct tagINCHI_CLOCK* ic,
                 }
             }
         }
-        inchi_ios_flush(pout);
+        flush_record_stream(pout, NULL);
         next_act = DO_EXIT_FUNCTION;
         goto exit_function;
 
@@ -1320,7 +1760,7 @@ int CalcAndPrintINCHIAndINCHIKEY(struct tagINCHI_CLOCK* ic,
                 }
             }
         }
-        inchi_ios_flush(pout);
+        flush_record_stream(pout, NULL);
         next_act = DO_CONTINUE_MAIN_LOOP;
         goto exit_function;
 
@@ -1441,8 +1881,8 @@ int CalcAndPrintINCHIAndINCHIKEY(struct tagINCHI_CLOCK* ic,
 
         if (!silent)
         {
-            inchi_ios_flush(pout);
-            inchi_ios_flush2(plog, stderr);
+            flush_record_stream(pout, NULL);
+            flush_record_stream(plog, stderr);
         }
         else
         {
@@ -1452,7 +1892,7 @@ int CalcAndPrintINCHIAndINCHIKEY(struct tagINCHI_CLOCK* ic,
     }
     else
     {
-        inchi_ios_flush(pout);
+        flush_record_stream(pout, NULL);
     }
 
 exit_function:
@@ -1462,6 +1902,411 @@ exit_function:
 }
 
 
+#if ( BUILD_WITH_THREADS == 1 )
+
+/*
+    Multi-threaded processing of input records (option Threads:N)
+
+    The main thread reads input records one by one (exactly as in serial
+    mode) and puts them into a ring of jobs; worker threads calculate
+    InChI/InChIKey for the queued jobs, each using its own CANON_GLOBALS,
+    INCHI_CLOCK and work buffers. All the output (out/log/problem file)
+    related to a record is collected in per-job string buffers which are
+    written by the main thread strictly in the order of input records, so
+    the results are identical to those of the serial run.
+*/
+
+#define RECORD_JOB_EMPTY        0   /* slot is free                         */
+#define RECORD_JOB_QUEUED       1   /* record read, waiting for a worker    */
+#define RECORD_JOB_RUNNING      2   /* InChI is being calculated            */
+#define RECORD_JOB_DONE         3   /* ready to be written                  */
+
+#define RECORD_JOBS_PER_THREAD  4   /* read-ahead depth, records per thread */
+
+typedef struct tagRecordJob
+{
+    int             state;
+    int             next_action;    /* MAIN_LOOP_ACTION                         */
+    int             nRet;
+    int             have_err_in_GetOneStructure;
+    long            num_inp;
+    long            num_err;        /* errors found in this record              */
+    unsigned long   ulProcessingTime;
+    INPUT_PARMS     ip;             /* snapshot made after reading the record   */
+    char            szSdfDataValue[MAX_SDF_VALUE + 1];
+    char            szTitle[MAX_SDF_HEADER + MAX_SDF_VALUE + 256];
+    STRUCT_DATA     sd;
+    ORIG_ATOM_DATA  orig_inp_data;
+    INCHI_IOSTREAM  out;            /* per-record output buffers;               */
+    INCHI_IOSTREAM  log;            /* written in the order of input records    */
+    INCHI_IOSTREAM  prb;
+} RECORD_JOB;
+
+typedef struct tagRecordPipeline
+{
+    INCHI_MUTEX     mutex;
+    INCHI_COND      job_queued;     /* signalled when a job is queued or on quit */
+    INCHI_COND      job_done;       /* signalled when a worker completes a job  */
+    RECORD_JOB     *jobs;           /* ring of jobs                             */
+    long            num_jobs;
+    long            num_read;       /* number of records put into the ring      */
+    long            num_dispatched; /* number of records looked at by workers   */
+    long            num_written;    /* number of records written and released   */
+    int             bQuit;
+    const char     *szInputPath;    /* to re-open input for problem file copies */
+    int             output_error_inchi;
+    char           *pLF;
+    char           *pTAB;
+    RUN_STAT        RunStat;        /* added by the workers when they quit      */
+} RECORD_PIPELINE;
+
+
+/*****************************************************************************
+ Free per-record data of the job and mark it empty
+*****************************************************************************/
+static void RecordJobFree(RECORD_JOB* job)
+{
+    inchi_ios_free_str(&job->out);
+    inchi_ios_free_str(&job->log);
+    inchi_ios_free_str(&job->prb);
+    FreeOrigAtData(&job->orig_inp_data);
+    job->state = RECORD_JOB_EMPTY;
+}
+
+
+/*****************************************************************************
+ Read the next input record into the job (main thread)
+*****************************************************************************/
+static void RecordJobRead(RECORD_PIPELINE* pl,
+    RECORD_JOB* job,
+    struct tagINCHI_CLOCK* ic,
+    INPUT_PARMS* ip,
+    INCHI_IOSTREAM* inp_file,
+    INCHI_IOSTREAM* pprb,
+    long* num_inp)
+{
+    inchi_ios_init(&job->out, INCHI_IOS_TYPE_STRING, NULL);
+    inchi_ios_init(&job->log, INCHI_IOS_TYPE_STRING, NULL);
+    /* the file is only used as 'problem file requested' flag */
+    inchi_ios_init(&job->prb, INCHI_IOS_TYPE_STRING, pprb->f);
+    job->nRet = 0;
+    job->have_err_in_GetOneStructure = 0;
+    job->num_err = 0;
+    job->ulProcessingTime = 0;
+
+    job->next_action = GetTheNextRecordOfInputFile(ic, &job->sd, ip, job->szTitle,
+        inp_file, &job->log, &job->out, &job->prb,
+        &job->orig_inp_data, num_inp, NULL,
+        &job->nRet, &job->have_err_in_GetOneStructure,
+        &job->num_err, pl->output_error_inchi);
+    job->num_inp = *num_inp;
+
+    /* reading a record changes SDfile ID value, structure number, etc. */
+    memcpy(&job->ip, ip, sizeof(job->ip));
+    if (ip->pSdfLabel == ip->szSdfDataHeader)
+    {
+        job->ip.pSdfLabel = job->ip.szSdfDataHeader;
+    }
+    if (ip->pSdfValue)
+    {
+        mystrncpy(job->szSdfDataValue, ip->pSdfValue, sizeof(job->szSdfDataValue));
+        job->ip.pSdfValue = job->szSdfDataValue;
+    }
+
+    if (job->next_action == DO_CONTINUE_MAIN_LOOP &&
+        job->nRet == _IS_ERROR && pl->output_error_inchi)
+    {
+        Output_RecordInfo(&job->out, job->num_inp, job->ip.bNoStructLabels,
+            job->ip.pSdfLabel, job->ip.pSdfValue, job->ip.lSdfId, pl->pLF, pl->pTAB);
+        emit_empty_inchi(&job->ip, job->num_inp, pl->pLF, pl->pTAB, &job->out);
+    }
+}
+
+
+/*****************************************************************************
+ Get the next queued job, if any (mutex must be locked)
+*****************************************************************************/
+static RECORD_JOB* RecordJobGetQueued(RECORD_PIPELINE* pl)
+{
+    if (pl->num_dispatched < pl->num_written)
+    {
+        pl->num_dispatched = pl->num_written;
+    }
+    while (pl->num_dispatched < pl->num_read)
+    {
+        RECORD_JOB* job = pl->jobs + pl->num_dispatched % pl->num_jobs;
+        pl->num_dispatched++;
+        if (job->state == RECORD_JOB_QUEUED)
+        {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*****************************************************************************
+ Worker thread: calculate InChI for queued records
+*****************************************************************************/
+static void RecordPipelineWorker(void* arg)
+{
+    RECORD_PIPELINE* pl = (RECORD_PIPELINE*)arg;
+    RECORD_JOB* job;
+    CANON_GLOBALS CG;
+    INCHI_CLOCK ic;
+    PINChI2* pINChI[INCHI_NUM];
+    PINChI_Aux2* pINChI_Aux[INCHI_NUM];
+    ORIG_ATOM_DATA PrepAtData[2];
+    INCHI_IOS_STRING temp_string_container;
+    INCHI_IOS_STRING* strbuf = &temp_string_container;
+    INCHI_IOSTREAM instr, * inp_file = &instr;
+    int bStrBuf;
+    char ikey0[28];
+
+    memset(&CG, 0, sizeof(CG)); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset(&ic, 0, sizeof(ic)); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset(pINChI, 0, sizeof(pINChI)); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset(pINChI_Aux, 0, sizeof(pINChI_Aux)); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset(PrepAtData, 0, sizeof(PrepAtData)); /* djb-rwth: memset_s C11/Annex K variant? */
+    memset(strbuf, 0, sizeof(*strbuf)); /* djb-rwth: memset_s C11/Annex K variant? */
+
+    /* private input file handle: problem structures are copied from the input */
+    inchi_ios_init(inp_file, INCHI_IOS_TYPE_FILE, NULL);
+    if (pl->szInputPath && pl->szInputPath[0])
+    {
+#if ( defined(_MSC_VER)&&defined(_WIN32) || defined(__BORLANDC__)&&defined(__WIN32__) || defined(__GNUC__)&&defined(__MINGW32__)&&defined(_WIN32) )
+        inp_file->f = fopen(pl->szInputPath, "rb");
+#else
+        inp_file->f = fopen(pl->szInputPath, "r");
+#endif
+    }
+
+    bStrBuf = 0 < inchi_strbuf_init(strbuf, INCHI_STRBUF_INITIAL_SIZE, INCHI_STRBUF_SIZE_INCREMENT);
+
+    for (;;)
+    {
+        inchi_mutex_lock(&pl->mutex);
+        while (!pl->bQuit && !(job = RecordJobGetQueued(pl)))
+        {
+            inchi_cond_wait(&pl->job_queued, &pl->mutex);
+        }
+        if (pl->bQuit)
+        {
+            inchi_mutex_unlock(&pl->mutex);
+            break;
+        }
+        job->state = RECORD_JOB_RUNNING;
+        inchi_mutex_unlock(&pl->mutex);
+
+        if (bStrBuf)
+        {
+            ikey0[0] = '\0';
+            job->next_action = CalcAndPrintINCHIAndINCHIKEY(&ic, &CG, &job->sd, &job->ip, job->szTitle,
+                pINChI, pINChI_Aux,
+                inp_file, &job->log, &job->out, &job->prb,
+                &job->orig_inp_data, PrepAtData, &job->num_inp, NULL,
+                &job->nRet, job->have_err_in_GetOneStructure,
+                &job->num_err, pl->output_error_inchi,
+                strbuf, &job->ulProcessingTime,
+                pl->pLF, pl->pTAB, ikey0,
+                0 /* not silent */);
+        }
+        else
+        {
+            inchi_ios_eprint(&job->log, "Cannot allocate internal string buffer. Terminating\n");
+            job->next_action = DO_EXIT_FUNCTION;
+        }
+
+        FreeAllINChIArrays(pINChI, pINChI_Aux, job->sd.num_components);
+        FreeOrigAtData(&job->orig_inp_data);
+        FreeOrigAtData(PrepAtData);
+        FreeOrigAtData(PrepAtData + 1);
+
+        inchi_mutex_lock(&pl->mutex);
+        job->state = RECORD_JOB_DONE;
+        inchi_cond_broadcast(&pl->job_done);
+        inchi_mutex_unlock(&pl->mutex);
+    }
+
+    inchi_mutex_lock(&pl->mutex);
+    RunStatAddCG(&pl->RunStat, &CG);
+    inchi_mutex_unlock(&pl->mutex);
+    inchi_ios_close(inp_file);
+    inchi_strbuf_close(strbuf);
+    CanonArenaFree(&CG);
+    BnsPoolFree(&CG);
+    RingCacheFree(&CG.m_RingCache);
+}
+
+
+/*****************************************************************************
+ Process all records of the input file in num_threads worker threads.
+ Returns 0 on success, -1 if the threads could not be started (nothing
+ has been read from input; the caller should fall back to serial mode).
+*****************************************************************************/
+int ProcessInputRecordsInThreads(struct tagINCHI_CLOCK* ic,
+    INPUT_PARMS* ip,
+    INCHI_IOSTREAM* inp_file,
+    INCHI_IOSTREAM* plog,
+    INCHI_IOSTREAM* pout,
+    INCHI_IOSTREAM* pprb,
+    int num_threads,
+    int output_error_inchi,
+    char* pLF,
+    char* pTAB,
+    long* num_inp,
+    long* num_err,
+    unsigned long* pulTotalProcessingTime,
+    RUN_STAT* pRunStat)
+{
+    RECORD_PIPELINE pipeline, * pl = &pipeline;
+    INCHI_THREAD* threads = NULL;
+    RECORD_JOB* job;
+    int i, num_started = 0, bEndOfInput = 0, next_action;
+    long k;
+    long num_inp_read = *num_inp;
+
+    memset(pl, 0, sizeof(*pl)); /* djb-rwth: memset_s C11/Annex K variant? */
+    pl->num_jobs = (long)num_threads * RECORD_JOBS_PER_THREAD;
+    pl->output_error_inchi = output_error_inchi;
+    pl->pLF = pLF;
+    pl->pTAB = pTAB;
+    pl->szInputPath = (pprb->f && inp_file->f != stdin) ? ip->path[0] : NULL;
+
+    pl->jobs = (RECORD_JOB*)inchi_calloc(pl->num_jobs, sizeof(pl->jobs[0]));
+    threads = (INCHI_THREAD*)inchi_calloc(num_threads, sizeof(threads[0]));
+    if (!pl->jobs || !threads)
+    {
+        goto exit_function;
+    }
+    if (inchi_mutex_init(&pl->mutex))
+    {
+        goto exit_function;
+    }
+    if (inchi_cond_init(&pl->job_queued) || inchi_cond_init(&pl->job_done))
+    {
+        inchi_mutex_destroy(&pl->mutex);
+        goto exit_function;
+    }
+    for (i = 0; i < num_threads; i++)
+    {
+        if (inchi_thread_create(threads + num_started, RecordPipelineWorker, pl))
+        {
+            break;
+        }
+        num_started++;
+    }
+
+    if (num_started)
+    {
+        for (;;)
+        {
+            /* read ahead */
+            while (!bEndOfInput && pl->num_read - pl->num_written < pl->num_jobs)
+            {
+                int state;
+                if (bInterrupted)
+                {
+                    bEndOfInput = 1;
+                    break;
+                }
+                job = pl->jobs + pl->num_read % pl->num_jobs;
+                RecordJobRead(pl, job, ic, ip, inp_file, pprb, &num_inp_read);
+                if (job->next_action == DO_NEXT_STEP)
+                {
+                    state = RECORD_JOB_QUEUED;
+                }
+                else
+                {
+                    /* nothing to calculate; just output messages */
+                    state = RECORD_JOB_DONE;
+                    if (job->next_action != DO_CONTINUE_MAIN_LOOP)
+                    {
+                        bEndOfInput = 1;
+                    }
+                }
+                inchi_mutex_lock(&pl->mutex);
+                job->state = state;
+                pl->num_read++;
+                if (state == RECORD_JOB_QUEUED)
+                {
+                    inchi_cond_signal(&pl->job_queued);
+                }
+                inchi_mutex_unlock(&pl->mutex);
+            }
+
+            if (pl->num_written == pl->num_read)
+            {
+                break;
+            }
+
+            /* write the oldest record as soon as it is ready */
+            job = pl->jobs + pl->num_written % pl->num_jobs;
+            inchi_mutex_lock(&pl->mutex);
+            while (job->state != RECORD_JOB_DONE)
+            {
+                inchi_cond_wait(&pl->job_done, &pl->mutex);
+            }
+            inchi_mutex_unlock(&pl->mutex);
+
+            job->out.f = pout->f;
+            inchi_ios_flush(&job->out);
+            job->log.f = plog->f;
+            inchi_ios_flush2(&job->log, stderr);
+            inchi_ios_flush(&job->prb);
+
+            *num_inp = job->num_inp;
+            *num_err += job->num_err;
+            *pulTotalProcessingTime += job->ulProcessingTime;
+            next_action = job->next_action;
+
+            inchi_mutex_lock(&pl->mutex);
+            RecordJobFree(job);
+            pl->num_written++;
+            inchi_mutex_unlock(&pl->mutex);
+
+            if (next_action == DO_EXIT_FUNCTION || next_action == DO_BREAK_MAIN_LOOP)
+            {
+                break;
+            }
+        }
+
+        /* stop workers; records read beyond the stop point are discarded */
+        inchi_mutex_lock(&pl->mutex);
+        pl->bQuit = 1;
+        inchi_cond_broadcast(&pl->job_queued);
+        inchi_mutex_unlock(&pl->mutex);
+    }
+
+    for (i = 0; i < num_started; i++)
+    {
+        inchi_thread_join(threads + i);
+    }
+    RunStatAdd(pRunStat, &pl->RunStat);
+    for (k = pl->num_written; k < pl->num_read; k++)
+    {
+        RecordJobFree(pl->jobs + k % pl->num_jobs);
+    }
+    inchi_cond_destroy(&pl->job_queued);
+    inchi_cond_destroy(&pl->job_done);
+    inchi_mutex_destroy(&pl->mutex);
+
+exit_function:
+    if (pl->jobs)
+    {
+        inchi_free(pl->jobs);
+    }
+    if (threads)
+    {
+        inchi_free(threads);
+    }
+
+    return num_started ? 0 : -1;
+}
+#endif /* BUILD_WITH_THREADS */
+
+
 #ifdef RENUMBER_ATOMS_AND_RECALC_V106
 
 /*****************************************************************************/
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+#
+# Balanced network search benchmark (v. 1.07+)
+#
+# Writes an SDfile of parallelogram benzenoids (graphene fragments of
+# 30-336 carbons with aromatic bonds, always Kekulean) repeated COPIES
+# times. Alternating-bond testing runs one balanced network search per
+# bond, so the search dominates the processing of such structures.
+# Each given inchi-1 executable processes the file RUNS times; the best
+# and median CPU times are printed.
+#
+# Usage:  bench_bns.py [-copies N] [-runs N] inchi-1 [inchi-1 ...]
+#
+
+import math
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+
+SIZES = [(3, 3), (5, 5), (8, 8), (10, 10), (12, 12), (14, 10)]
+BOND = 1.42
+
+
+def parallelogram(m, n):
+    """Carbon coordinates and bonds of an m x n hexagon parallelogram"""
+    h = math.sqrt(3) * BOND
+    atoms = {}
+    for i in range(m):
+        for j in range(n):
+            cx, cy = i * h + j * h / 2, j * 1.5 * BOND
+            for k in range(6):
+                t = math.pi / 6 + k * math.pi / 3
+                atoms[(round(cx + BOND * math.cos(t), 3),
+                       round(cy + BOND * math.sin(t), 3))] = 1
+    pts = list(atoms)
+    bonds = [(a, b) for a in range(len(pts)) for b in range(a + 1, len(pts))
+             if abs(math.dist(pts[a], pts[b]) - BOND) < 0.05]
+    return pts, bonds
+
+
+def molfile(name, pts, bonds):
+    """Molfile record with explicit H on the 2-connected carbons"""
+    deg = [0] * len(pts)
+    for a, b in bonds:
+        deg[a] += 1
+        deg[b] += 1
+    num_c = len(pts)
+    pts, bonds = list(pts), [(a, b, 4) for a, b in bonds]
+    for a in range(num_c):
+        if deg[a] == 2:
+            pts.append((pts[a][0] * 1.05, pts[a][1] * 1.05))
+            bonds.append((a, len(pts) - 1, 1))
+    lines = [name, "", "", "%3d%3d  0  0  0  0  0  0  0  0999 V2000" % (len(pts), len(bonds))]
+    for k, (x, y) in enumerate(pts):
+        lines.append("%10.4f%10.4f%10.4f %-3s 0  0  0  0  0  0  0  0  0  0  0  0"
+                     % (x, y, 0, "C" if k < num_c else "H"))
+    for a, b, t in bonds:
+        lines.append("%3d%3d  %d  0  0  0  0" % (a + 1, b + 1, t))
+    lines += ["M  END", "$$$$", ""]
+    return "\n".join(lines)
+
+
+def cpu_time(args):
+    r0 = resource.getrusage(resource.RUSAGE_CHILDREN)
+    subprocess.run(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
+    r1 = resource.getrusage(resource.RUSAGE_CHILDREN)
+    return r1.ru_utime + r1.ru_stime - r0.ru_utime - r0.ru_stime
+
+
+def main(argv):
+    copies, runs, exes = 100, 7, []
+    while argv:
+        arg = argv.pop(0)
+        if arg in ("-copies", "-runs") and argv:
+            if arg == "-copies":
+                copies = int(argv.pop(0))
+            else:
+                runs = int(argv.pop(0))
+        else:
+            exes.append(os.path.abspath(arg))
+    if not exes:
+        sys.exit("Usage: bench_bns.py [-copies N] [-runs N] inchi-1 [inchi-1 ...]")
+
+    records = []
+    for m, n in SIZES:
+        pts, bonds = parallelogram(m, n)
+        records.append(molfile("para %dx%d n=%d" % (m, n, len(pts)), pts, bonds))
+    with tempfile.TemporaryDirectory() as tmp:
+        inp = os.path.join(tmp, "benzenoids.sdf")
+        with open(inp, "w") as f:
+            f.write("".join(records) * copies)
+        times = {exe: [] for exe in exes}
+        for _ in range(runs):
+            for exe in exes:  # interleaved to spread out machine noise
+                times[exe].append(cpu_time([exe, inp, os.path.join(tmp, "out.txt"),
+                                            os.path.join(tmp, "out.log"),
+                                            os.path.join(tmp, "out.prb")]))
+    print("%d structures, %d runs" % (len(SIZES) * copies, runs))
+    for exe in exes:
+        t = sorted(times[exe])
+        print("%s: best %.2f s, median %.2f s" % (exe, t[0], t[len(t) // 2]))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
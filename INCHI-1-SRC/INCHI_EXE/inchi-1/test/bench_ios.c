@@ -0,0 +1,55 @@
+/*
+    Benchmark of the output stage (v. 1.07+)
+
+    Writes NUM_RECORDS records to a string INCHI_IOSTREAM as inchi-1 does
+    for each structure: an InChI with 6 layers, an AuxInfo line, a log
+    line, an InChIKey and 4 molfile atom lines with coordinates as with
+    OutputSDF; the buffer is emptied after each record as after
+    flushing it to the output file. Prints the CPU time.
+    Built and run by bench_ios.sh.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mode.h"
+#include "ichi_io.h"
+
+#define NUM_RECORDS 1000000L
+
+
+/****************************************************************************/
+int main( int argc, char *argv[] )
+{
+    INCHI_IOSTREAM out;
+    long i, num_records = ( argc > 1 ) ? atol( argv[1] ) : NUM_RECORDS;
+    int k;
+    double x;
+    clock_t c0;
+
+    inchi_ios_init( &out, INCHI_IOS_TYPE_STRING, NULL );
+    c0 = clock( );
+    for (i = 0; i < num_records; i++)
+    {
+        inchi_ios_print( &out, "%s%s", "InChI=1S/", "C17H19NO3" );
+        for (k = 0; k < 6; k++)
+        {
+            inchi_ios_print( &out, "/%s%s", "c", "1-18-7-6-17-10-3-5-13(20)16(17)21-15-12(19)4-2-9(14(15)17)8-11(10)18" );
+        }
+        inchi_ios_print( &out, "\n" );
+        inchi_ios_print( &out, "AuxInfo=1/1/N:%d,%d,%d,%d/rA:%dnC%s\n", 1, 2, 3, 4, 21, "CCOCCNCCC" );
+        inchi_ios_eprint( &out, "Structure: %ld. %s\n", i + 1, "Warning: ..." );
+        inchi_ios_print( &out, "InChIKey=%-27.27s\n", "BQJCRHHNABKAKU-KBQPJGBKSA-N" );
+        for (k = 0; k < 4; k++)
+        {
+            x = (double) ( ( i * 4 + k ) % 200001 - 100000 ) / 10000.0;
+            inchi_ios_print( &out, "%10.4f%10.4f%10.4f %-3s 0  0  0  0  0  0  0  0  0  0  0  0\n", x, -x, 0.0, "C" );
+        }
+        out.s.nUsedLength = 0; /* as after flushing to file */
+    }
+    printf( "%ld records: %.2f s\n", num_records, (double) ( clock( ) - c0 ) / CLOCKS_PER_SEC );
+    inchi_ios_close( &out );
+
+    return 0;
+}
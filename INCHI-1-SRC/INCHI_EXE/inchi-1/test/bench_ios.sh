@@ -0,0 +1,55 @@
+#!/bin/sh
+#
+# Output stage benchmark (v. 1.07+): builds check_ios.c and bench_ios.c
+# against the INCHI_BASE sources of each given InChI source tree (default:
+# the tree this script belongs to) with the compiler options of the CMake
+# build, checks that the string stream output equals that of the C
+# runtime and runs the benchmark RUNS times (default 5).
+# Exits with 1 if the check fails.
+#
+# Usage:  bench_ios.sh [source_root ...]
+#         (source_root contains INCHI-1-SRC; $CC defaults to cc,
+#         objects go to $BENCH_BUILD_DIR, default ./_bench_build)
+#
+# Example, before and after a change:
+#   git worktree add /tmp/inchi-old HEAD~1
+#   bench_ios.sh /tmp/inchi-old .
+#
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+BUILD_DIR=${BENCH_BUILD_DIR:-./_bench_build}
+CC=${CC:-cc}
+RUNS=${RUNS:-5}
+[ $# -eq 0 ] && set -- "$TEST_DIR/../../../.."
+
+status=0
+n=0
+for root in "$@"; do
+    n=$((n + 1))
+    base=$root/INCHI-1-SRC/INCHI_BASE/src
+    out=$BUILD_DIR/$n
+    if [ ! -d "$base" ]; then
+        echo "No INCHI-1-SRC/INCHI_BASE/src in '$root'" >&2
+        exit 2
+    fi
+    mkdir -p "$out/obj"
+    for f in "$base"/*.c "$TEST_DIR/check_ios.c" "$TEST_DIR/bench_ios.c"; do
+        dir=$out/obj
+        case $f in "$TEST_DIR"/*) dir=$out ;; esac
+        $CC -c -g -O1 -fno-strict-aliasing -std=c11 -D_GNU_SOURCE \
+            -DCOMPILE_ANSI_ONLY -DTARGET_EXE_STANDALONE \
+            -I"$base" -w "$f" -o "$dir/$(basename "$f" .c).o" &
+    done
+    wait
+    for prog in check_ios bench_ios; do
+        $CC "$out/$prog.o" "$out"/obj/*.o -o "$out/$prog" -lm -lpthread || exit 2
+    done
+    echo "$root:"
+    "$out/check_ios" || status=1
+    i=0
+    while [ $i -lt "$RUNS" ]; do
+        "$out/bench_ios"
+        i=$((i + 1))
+    done
+done
+exit $status
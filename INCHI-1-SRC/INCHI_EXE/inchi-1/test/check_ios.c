@@ -0,0 +1,107 @@
+/*
+    Check of the string stream output (v. 1.07+)
+
+    Prints numbers and strings with the formats used by inchi-1 (molfile
+    coordinates, AuxInfo, log lines, InChIKey) to a string INCHI_IOSTREAM
+    and compares the result byte for byte with snprintf() of the C runtime.
+    Returns 0 if all outputs are equal, 1 otherwise.
+    Built and run by bench_ios.sh.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mode.h"
+#include "ichi_io.h"
+
+#define NUM_VALUES 1000000L
+
+static unsigned long long Rand( unsigned long long *state );
+static int CheckOne( INCHI_IOSTREAM *out, long *num_diff, const char *fmt, const char *result, int len );
+
+
+/****************************************************************************/
+static unsigned long long Rand( unsigned long long *state )
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 11;
+}
+
+
+/****************************************************************************
+    Compare the last string stream output with the C runtime result
+****************************************************************************/
+static int CheckOne( INCHI_IOSTREAM *out, long *num_diff, const char *fmt, const char *result, int len )
+{
+    int bDiff = out->s.nUsedLength != len || memcmp( out->s.pStr, result, len );
+
+    if (bDiff && ( *num_diff )++ < 10)
+    {
+        printf( "format \"%s\": \"%s\" instead of \"%s\"\n", fmt, out->s.pStr, result );
+    }
+    out->s.nUsedLength = 0;
+
+    return bDiff;
+}
+
+
+/****************************************************************************/
+int main( int argc, char *argv[] )
+{
+    static const char *dfmt[] = { "%.4f", "%10.4f", "%.3f", "%5.1f", "%10.2f", "%10.2e",
+                                  "%10.3e", "%g", "%10g", "%f", "%-12.5f|" };
+    static const char *ifmt[] = { "%d", "%3d", "%-5d", "%ld", "%x", "%08X", "%c" };
+    INCHI_IOSTREAM out;
+    unsigned long long state = 12345;
+    long i, num_values = ( argc > 1 ) ? atol( argv[1] ) : NUM_VALUES, num_diff = 0;
+    int k, len;
+    char result[256];
+
+    inchi_ios_init( &out, INCHI_IOS_TYPE_STRING, NULL );
+    for (i = 0; i < num_values; i++)
+    {
+        /* molfile-like coordinates with 5 decimals: many exact ties at 4 */
+        double x = (double) ( (long long) ( Rand( &state ) % 20000001 ) - 10000000 ) / 100000.0;
+        double y = (double) Rand( &state ) / (double) ( 1ULL << 53 ) * 1.0e6 - 5.0e5;
+        long n = (long) ( Rand( &state ) % 2000001 ) - 1000000;
+        for (k = 0; k < (int) ( sizeof( dfmt ) / sizeof( dfmt[0] ) ); k++)
+        {
+            inchi_ios_print( &out, dfmt[k], x );
+            len = snprintf( result, sizeof( result ), dfmt[k], x );
+            CheckOne( &out, &num_diff, dfmt[k], result, len );
+            inchi_ios_print( &out, dfmt[k], y );
+            len = snprintf( result, sizeof( result ), dfmt[k], y );
+            CheckOne( &out, &num_diff, dfmt[k], result, len );
+        }
+        for (k = 0; k < (int) ( sizeof( ifmt ) / sizeof( ifmt[0] ) ); k++)
+        {
+            if (ifmt[k][1] == 'l')
+            {
+                inchi_ios_print( &out, ifmt[k], n );
+                len = snprintf( result, sizeof( result ), ifmt[k], n );
+            }
+            else
+            {
+                int m = ( ifmt[k][1] == 'c' ) ? 32 + (int) ( n & 63 ) : (int) n;
+                inchi_ios_print( &out, ifmt[k], m );
+                len = snprintf( result, sizeof( result ), ifmt[k], m );
+            }
+            CheckOne( &out, &num_diff, ifmt[k], result, len );
+        }
+        inchi_ios_print( &out, "%10.4f%10.4f%10.4f %-3s%2d%3d", x, y, -x, "C", (int) ( n % 10 ), 0 );
+        len = snprintf( result, sizeof( result ), "%10.4f%10.4f%10.4f %-3s%2d%3d", x, y, -x, "C", (int) ( n % 10 ), 0 );
+        CheckOne( &out, &num_diff, "%10.4f%10.4f%10.4f %-3s%2d%3d", result, len );
+        inchi_ios_eprint( &out, "Structure: %ld. %s%%\n", n, "Warning: ..." );
+        len = snprintf( result, sizeof( result ), "Structure: %ld. %s%%\n", n, "Warning: ..." );
+        CheckOne( &out, &num_diff, "Structure: %ld. %s%%\n", result, len );
+        inchi_ios_print( &out, "InChIKey=%-27.27s\n", "BQJCRHHNABKAKU-KBQPJGBKSA-N-TOO-LONG" );
+        len = snprintf( result, sizeof( result ), "InChIKey=%-27.27s\n", "BQJCRHHNABKAKU-KBQPJGBKSA-N-TOO-LONG" );
+        CheckOne( &out, &num_diff, "InChIKey=%-27.27s\n", result, len );
+    }
+    inchi_ios_close( &out );
+    printf( "%ld values: %ld output%s differ%s from the C runtime\n",
+            num_values, num_diff, num_diff == 1 ? "" : "s", num_diff == 1 ? "s" : "" );
+
+    return num_diff ? 1 : 0;
+}
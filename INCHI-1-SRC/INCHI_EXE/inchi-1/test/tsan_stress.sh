@@ -0,0 +1,96 @@
+#!/bin/sh
+#
+# ThreadSanitizer stress test of concurrent structure processing (v. 1.07+)
+#
+# Builds inchi-1 with -fsanitize=thread, processes the input file serially
+# and then in NUM_THREADS threads (-Threads), with components in parallel
+# (-CompThreads) and both. The InChI strings of the serial run are then
+# read back with -InChI2InChI and -InChI2Struct, serially and with
+# -Threads and -CompThreads. The test checks that
+#   - ThreadSanitizer reports no data races,
+#   - the output of every threaded run equals the serial output.
+#
+# Usage:  tsan_stress.sh input_file [NUM_THREADS [extra inchi-1 options]]
+#         (default NUM_THREADS is 32; the objects and the executable
+#         go to $TSAN_BUILD_DIR, default ./_tsan_build; the compiler
+#         is $CC, default cc, which must support -fsanitize=thread)
+#
+# Example:
+#   tsan_stress.sh structures.sdf 32 -RecMet -FixedH
+#
+
+if [ $# -lt 1 ] || [ ! -f "$1" ]; then
+    echo "Usage: $0 input_file [NUM_THREADS [extra inchi-1 options]]" >&2
+    exit 2
+fi
+INPUT=$1
+NUM_THREADS=${2:-32}
+[ $# -ge 2 ] && shift
+shift
+EXE_DIR=$(cd "$(dirname "$0")/../src" && pwd)
+BASE_DIR=$(cd "$EXE_DIR/../../../INCHI_BASE/src" && pwd)
+BUILD_DIR=${TSAN_BUILD_DIR:-./_tsan_build}
+WORK_DIR=$BUILD_DIR/stress
+CC=${CC:-cc}
+INCHI=$BUILD_DIR/inchi-1
+
+# same definitions as the CMake build of inchi-1
+mkdir -p "$BUILD_DIR"
+for f in "$BASE_DIR"/*.c "$EXE_DIR"/*.c; do
+    $CC -c -g -O1 -fno-strict-aliasing -std=c11 -D_GNU_SOURCE -fsanitize=thread \
+        -DCOMPILE_ANSI_ONLY -DTARGET_EXE_STANDALONE -DADD_AMI_MODE \
+        -I"$BASE_DIR" -I"$EXE_DIR" -w "$f" -o "$BUILD_DIR/$(basename "$f" .c).o" &
+done
+wait
+$CC -fsanitize=thread "$BUILD_DIR"/*.o -o "$INCHI" -lm -lpthread ||
+    { echo "Build failed" >&2; exit 2; }
+mkdir -p "$WORK_DIR"
+
+TSAN_OPTIONS="halt_on_error=1 exitcode=66 $TSAN_OPTIONS"
+export TSAN_OPTIONS
+
+# run NAME options...: read $INPUT, output to $WORK_DIR/NAME.txt, log to NAME.log
+run()
+{
+    name=$1
+    shift
+    "$INCHI" "$INPUT" "$WORK_DIR/$name.txt" "$WORK_DIR/$name.log" "$WORK_DIR/$name.prb" \
+        "$@" >/dev/null 2>"$WORK_DIR/$name.err"
+    if [ $? -eq 66 ] || grep -q "ThreadSanitizer" "$WORK_DIR/$name.err"; then
+        echo "FAILED: data race in '$name' run, see $WORK_DIR/$name.err"
+        exit 1
+    fi
+}
+
+# check SERIAL_NAME options...: run with options, compare to SERIAL_NAME.txt
+check()
+{
+    serial=$1
+    shift
+    name=$(echo "$*" | tr -d ' :-')
+    run "$name" "$@"
+    if cmp -s "$WORK_DIR/$serial.txt" "$WORK_DIR/$name.txt"; then
+        echo "OK:     $*"
+    else
+        echo "FAILED: $* output differs from the serial run"
+        status=1
+    fi
+}
+
+status=0
+run serial "$@"
+for mode in "-Threads:$NUM_THREADS" "-CompThreads:$NUM_THREADS" "-Threads:$NUM_THREADS -CompThreads:4"; do
+    # shellcheck disable=SC2086
+    check serial $mode "$@"
+done
+
+# InChI strings as input; the extra options are not passed on
+INPUT=$WORK_DIR/serial.txt
+for conv in -InChI2InChI -InChI2Struct; do
+    run "serial$conv" $conv
+    # shellcheck disable=SC2086
+    check "serial$conv" $conv "-Threads:$NUM_THREADS"
+    # shellcheck disable=SC2086
+    check "serial$conv" $conv "-Threads:$NUM_THREADS" -CompThreads:4
+done
+exit $status
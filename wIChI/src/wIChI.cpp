@@ -241,7 +241,11 @@ int CWINChIApp::ExitInstance()
 	
 	
 	if( !gbThreadON  )
-		::SetBitFree( &CG );
+	{
+		::CanonArenaFree( &CG );
+		::BnsPoolFree( &CG );
+		::RingCacheFree( &CG.m_RingCache );
+	}
 	
 	return CWinApp::ExitInstance();
 }
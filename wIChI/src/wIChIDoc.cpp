@@ -527,6 +527,10 @@ void CWINChIDoc::ProcessInput(BOOL bBatch, int how)
 	pCG = & ((CWINChIApp*)AfxGetApp())->CG;
 	pic = & ((CWINChIApp*)AfxGetApp())->ic;
 
+	/* release the buffers kept by the previous run */
+	CanonArenaFree( pCG );
+	BnsPoolFree( pCG );
+	RingCacheFree( &pCG->m_RingCache );
 	memset( pCG, 0, sizeof(*pCG));
 	memset( pic, 0, sizeof(*pic));
 